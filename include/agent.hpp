@@ -0,0 +1,58 @@
+#ifndef TETRIS_AGENT_HPP_
+#define TETRIS_AGENT_HPP_
+
+
+#include <memory>
+#include <random>
+#include <string>
+
+#include "game.hpp"
+#include "movegen.hpp"
+
+
+namespace Tetris {
+
+
+// Agents play a Game without a human at the keyboard. Act() is called once
+// per tick, before the game advances, and may issue any number of inputs.
+class Agent {
+public:
+  virtual ~Agent() = default;
+  virtual void Act(Game&) = 0;
+};
+
+
+// Picks a random rotation and column for every piece and hard drops it.
+class RandomAgent : public Agent {
+public:
+  RandomAgent(uint64_t seed);
+  void Act(Game&) override;
+
+private:
+  std::minstd_rand rng_;
+  uint64_t placed_ = ~uint64_t{0};
+};
+
+
+// Locks every piece at the reachable placement with the best score on a
+// weighted sum of aggregate height, completed lines, holes and bumpiness.
+class GreedyAgent : public Agent {
+public:
+  void Act(Game&) override;
+
+private:
+  static double Evaluate(Board);
+
+  MoveGenerator generator_;
+  uint64_t placed_ = ~uint64_t{0};
+};
+
+
+// Create an agent by name. Returns nullptr if the name is unknown.
+std::unique_ptr<Agent> MakeAgent(const std::string& name, uint64_t seed);
+
+
+} // namespace Tetris
+
+
+#endif
@@ -1,17 +1,74 @@
 #pragma once
 
-#include <vector>
+#include <cstdint>
+#include <type_traits>
 
 namespace Tetris {
 
 
-struct Board {
+// Smallest unsigned integer type with at least the given number of bits
+template <int Bits>
+using UintFor = std::conditional_t<(Bits <= 16), uint16_t,
+                std::conditional_t<(Bits <= 32), uint32_t, uint64_t>>;
+
+
+// The playfield is stored as a bitboard: each row is a mask where bit `col` is
+// set if the cell at (row, col) is filled. A whole 10x24 board is then 48
+// bytes, and checking a row or a piece against the board is a shift-and-AND.
+//
+// The dimensions are template parameters, so every loop over the board has
+// constant bounds and the row type is just wide enough for the columns.
+template <int Rows, int Cols>
+struct BasicBoard {
+  static_assert(Rows <= 64 && Cols <= 64, "rows and columns are bitmasks");
+
+  using Row = UintFor<Cols>;
+  using RowMask = UintFor<Rows>; // Set of rows, bit i for row i
+
   void Clear();
+  bool Filled(int row, int col) const;
+  void Fill(int row, int col);
+  bool RowIsFull(int row) const;
 
-  static const int rows = 24;
-  static const int cols = 10;
-  int matrix[rows][cols];
+  static constexpr int rows = Rows;
+  static constexpr int cols = Cols;
+  static constexpr Row full_row = Row(~Row{0}) >> (8*sizeof(Row) - Cols);
+  Row matrix[rows];
 };
 
 
+// The standard board, and the variants used for research. Any other size
+// must also be added to the explicit instantiations in game.cpp,
+// movegen.cpp, game_batch.cpp, observation.cpp and versus.cpp.
+using Board = BasicBoard<24, 10>;
+using TallBoard = BasicBoard<44, 10>;
+using WideBoard = BasicBoard<24, 20>;
+
+
+template <int Rows, int Cols>
+void BasicBoard<Rows, Cols>::Clear() {
+  for (int row = 0; row < rows; ++row) {
+    matrix[row] = 0;
+  }
+}
+
+
+template <int Rows, int Cols>
+bool BasicBoard<Rows, Cols>::Filled(int row, int col) const {
+  return (matrix[row] >> col) & 1;
+}
+
+
+template <int Rows, int Cols>
+void BasicBoard<Rows, Cols>::Fill(int row, int col) {
+  matrix[row] |= Row{1} << col;
+}
+
+
+template <int Rows, int Cols>
+bool BasicBoard<Rows, Cols>::RowIsFull(int row) const {
+  return matrix[row] == full_row;
+}
+
+
 } // namespace Tetris
@@ -0,0 +1,154 @@
+#ifndef TETRIS_EVENT_STREAM_HPP_
+#define TETRIS_EVENT_STREAM_HPP_
+
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+#include "piece.hpp"
+
+
+namespace Tetris {
+
+
+enum class EventType : uint8_t {
+  SPAWN, // A new piece entered the board
+  MOVE, // The current piece moved, by input or gravity
+  ROTATE, // The current piece rotated, possibly with a wall kick
+  LOCK, // The piece was fixed to the board at its current position
+  CLEAR, // value rows were removed from the board
+  LEVEL, // The game advanced to level value
+  TOP_OUT, // The game is over
+  GARBAGE // value rows of garbage rose from the bottom
+};
+
+
+// Something that happened in a game. The piece fields describe the current
+// piece after the event, or the locked piece for LOCK.
+struct GameEvent {
+  uint64_t tick; // Game tick the event happened on
+  EventType type;
+  PieceType piece;
+  uint8_t rotation;
+  int8_t row;
+  int8_t col;
+  uint16_t value;
+};
+
+static_assert(sizeof(GameEvent) == 16);
+
+
+// Broadcast ring buffer with one writing game and any number of readers on
+// other threads. The writer never waits for readers: once the buffer wraps,
+// old events are overwritten and a reader that falls behind skips ahead,
+// counting what it missed. Each slot carries a sequence number that readers
+// check before and after copying it, so neither side takes a lock.
+class EventStream {
+public:
+  static constexpr uint64_t capacity = 1024;
+
+  void Push(const GameEvent&); // Only ever called from one thread
+  uint64_t head() const; // Number of events pushed so far
+
+private:
+  friend class EventReader;
+
+  static constexpr uint64_t mask = capacity - 1;
+  static_assert((capacity & mask) == 0, "capacity must be a power of two");
+
+  // An event is stored as two words so every access is atomic. seq is odd
+  // while the slot is being written and 2*(index+1) once event index is in.
+  struct Slot {
+    std::atomic<uint64_t> seq{0};
+    std::atomic<uint64_t> words[2];
+  };
+
+  alignas(64) std::atomic<uint64_t> head_{0};
+  alignas(64) std::array<Slot, capacity> slots_;
+};
+
+
+// Cursor into an EventStream. Each reader sees every event pushed after it
+// was created, unless it falls more than a full buffer behind.
+class EventReader {
+public:
+  explicit EventReader(const EventStream&);
+
+  // Copy the next event out and advance. Returns false if there is none yet.
+  bool Next(GameEvent&);
+  uint64_t dropped() const; // Events overwritten before they were read
+
+private:
+  const EventStream* stream_;
+  uint64_t cursor_;
+  uint64_t dropped_ = 0;
+};
+
+
+inline void EventStream::Push(const GameEvent& event) {
+  uint64_t words[2];
+  std::memcpy(words, &event, sizeof(words));
+
+  const auto index = head_.load(std::memory_order_relaxed);
+  auto& slot = slots_[index & mask];
+  slot.seq.store(2*index + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.words[0].store(words[0], std::memory_order_relaxed);
+  slot.words[1].store(words[1], std::memory_order_relaxed);
+  slot.seq.store(2*index + 2, std::memory_order_release);
+  head_.store(index + 1, std::memory_order_release);
+}
+
+
+inline uint64_t EventStream::head() const {
+  return head_.load(std::memory_order_acquire);
+}
+
+
+inline EventReader::EventReader(const EventStream& stream)
+    : stream_{&stream}, cursor_{stream.head()} {
+}
+
+
+inline bool EventReader::Next(GameEvent& event) {
+  while (true) {
+    const auto head = stream_->head();
+    if (cursor_ == head) { return false; }
+
+    // Skip whatever the writer has already overwritten
+    if (head - cursor_ > EventStream::capacity) {
+      dropped_ += head - cursor_ - EventStream::capacity;
+      cursor_ = head - EventStream::capacity;
+    }
+
+    const auto& slot = stream_->slots_[cursor_ & EventStream::mask];
+    const auto seq = slot.seq.load(std::memory_order_acquire);
+    uint64_t words[2];
+    words[0] = slot.words[0].load(std::memory_order_relaxed);
+    words[1] = slot.words[1].load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    // A different sequence means the writer lapped us while we read
+    if (seq != 2*cursor_ + 2 ||
+        slot.seq.load(std::memory_order_relaxed) != seq) {
+      continue;
+    }
+
+    std::memcpy(&event, words, sizeof(words));
+    cursor_ += 1;
+    return true;
+  }
+}
+
+
+inline uint64_t EventReader::dropped() const {
+  return dropped_;
+}
+
+
+} // namespace Tetris
+
+
+#endif
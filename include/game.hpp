@@ -1,83 +1,235 @@
 #ifndef TETRIS_GAME_HPP_
 #define TETRIS_GAME_HPP_
 
-#include <memory>
-#include <random>
-#include <functional>
+#include <type_traits>
+#include <array>
 
 #include "board.hpp"
+#include "event_stream.hpp"
 #include "piece.hpp"
+#include "piece_queue.hpp"
+#include "randomizer.hpp"
 
 
 namespace Tetris {
 
 
-class Game {
-public:
-  using Piece_ptr = std::unique_ptr<Piece>;
-  using RowIndices = std::vector<int>;
+enum class GameState : uint8_t {
+  PLAYING, PAUSED, ROWCLEAR, GAMEOVER
+};
+
+
+// Player inputs that move the current piece, see BasicGame::Apply()
+enum class Input : uint8_t {
+  LEFT, RIGHT, ROTATE_CW, ROTATE_CCW, SOFT_DROP, HARD_DROP
+};
+
+
+// Rows of garbage waiting to rise into a game, all with the hole in the
+// same column
+struct Garbage {
+  uint8_t rows;
+  int8_t hole;
+};
 
-  enum class State {
-    PLAYING, PAUSED, ROWCLEAR, GAMEOVER
-  };
 
-  Game();
-  void Step(double dt); // Call in game loop to move game forward
+// Simulation parameters. All durations are in ticks, so a game driven
+// through Tick() depends only on the seed and the inputs, never on frame
+// timing. The defaults correspond to a 1 kHz tick.
+struct GameConfig {
+  static GameConfig WithTickRate(int tick_rate);
+
+  int tick_rate = 1000; // Ticks per second of game time, used by Step()
+  int gravity_ticks = 1000; // Ticks per row of gravity on level 1
+  int quick_drop_ticks = 50; // Ticks per row of gravity while quick dropping
+  int row_clear_ticks = 1000; // Ticks full rows are shown before clearing
+  int das_ticks = 167; // Ticks a sideways key is held before it repeats
+  int arr_ticks = 33; // Ticks between repeats, 0 to shift to the wall
+  uint64_t seed = 0;
+  RandomizerPolicy randomizer = RandomizerPolicy::UNIFORM;
+  int preview = 5; // Length of the queue, up to PieceQueue::capacity
+};
+
+
+template <typename BoardT>
+struct BasicGameSnapshot;
+
+
+// A game of tetris on a board of type BoardT. Use the Game alias for the
+// standard 10x24 board.
+template <typename BoardT>
+class BasicGame {
+public:
+  using Board = BoardT;
+  using RowMask = typename Board::RowMask; // Bit i is set for row i
+  using State = GameState;
+  using Input = Tetris::Input;
+  using Config = GameConfig;
+  using GameSnapshot = BasicGameSnapshot<Board>;
+
+  static constexpr int max_states = 4; // Maximum depth of the state stack
+  // Pending garbage entries, enough for a hole per row of a full board
+  static constexpr int max_garbage = Board::rows;
+
+  BasicGame(); // Default config, seeded from the clock
+  explicit BasicGame(const Config&);
+  void Tick(); // Advance the game by exactly one tick
+  void Step(double dt); // Call in game loop to move game forward dt seconds
+  void Apply(Input);
   void MovePieceLeft();
   void MovePieceRight();
+  void MovePieceDown(); // Move one row down without locking the piece
   void HardDrop(); // Immediately drop piece to floor
   void QuickDrop(bool); // Increase drop speed
   void RotatePiece();
+  void RotatePieceCCW();
   void Restart();
   void TogglePause();
-  RowIndices GetFullRows() const;
+
+  // Publish events about the game to a stream, or stop if null. The stream
+  // must outlive the game or be detached first. Copies inherit the stream,
+  // so detach a copy before searching with it: only one game may publish.
+  void SetEventStream(EventStream*);
+
+  // Queue rows of garbage with a hole in the given column. Pending garbage
+  // rises from the bottom when the next piece locks without clearing rows.
+  // Rows beyond max_garbage entries join the newest entry. Ignored if the
+  // hole is not a column of the board.
+  void QueueGarbage(int rows, int hole);
+
+  // Cancel up to rows of pending garbage, oldest first. Returns the number
+  // of rows left over.
+  int CancelGarbage(int rows);
+  int pending_garbage() const; // Rows of garbage waiting to rise
+
+  // Save and load the complete game state. The game restored into must have
+  // been created with the same Config.
+  GameSnapshot Snapshot() const;
+  void Restore(const GameSnapshot&);
+  RowMask FullRows() const; // Rows waiting to be cleared
 
   // Get points corresponding to where the current piece will end up
   Points GetDestination() const;
 
+  // Check whether a piece fits on the board
+  bool ValidPosition(const Piece&) const;
+
+  // Number of rows a valid piece can fall before it lands
+  int DropDistance(const Piece&) const;
+
+  // Rotate a piece to the given rotation state, trying the SRS wall kicks if
+  // the basic rotation is blocked. Leaves the piece untouched and returns
+  // false if no kick fits.
+  bool TryRotate(Piece&, int to) const;
+
   uint64_t score() const;
   uint64_t level() const;
+  uint64_t pieces() const; // Pieces locked since the last restart
+  uint64_t lines() const; // Rows cleared since the last restart
+  uint64_t tick() const; // Ticks simulated since construction
+  uint64_t hash() const; // Zobrist hash of the board and current piece
   State state() const;
+  bool game_over() const; // Topped out, before state() catches up
+  const Config& config() const;
+  const PieceQueue& queue() const; // Pieces after the current one
 
   Board board;
-  Piece_ptr current_piece;
-  Piece_ptr next_piece;
+  Piece current_piece;
 
 private:
-  using WallKickTable = std::vector<std::vector<std::pair<int, int>>>;
-  using StateStack = std::vector<std::function<void (Game*, double)>>;
+  void PushState(State);
+  void PopState();
 
   void LockPieceAndSpawnNew();
-  void ClearRow(int);
   void ClearFullRows();
   void CheckGameOver();
   void CheckLevel();
-  bool RowIsFull(int) const;
-  bool ValidPosition(const Points&) const;
-  Piece_ptr GetRandomPiece();
+  void TopOut();
+  void RaiseGarbage();
+  void UpdateSurface();
+  int DropTicks() const;
+  void SpawnNext();
+  void Emit(EventType, uint16_t value = 0) const;
 
   // States
-  void PlayingStep(double dt);
-  void RowClearStep(double dt);
-  void PausedStep(double dt);
-  void GameOverStep(double dt);
-
-  double time_ = 0.0;
-  double pause_time_ = 1.0;
-  double row_clear_time_ = 1.0;
+  void PlayingStep();
+  void RowClearStep();
+  void PausedStep();
+  void GameOverStep();
+
+  Config config_;
+  uint64_t tick_ = 0;
+  double step_remainder_ = 0.0; // Fraction of a tick left over by Step()
+  int timer_ = 0; // Ticks spent since the last gravity step or in row clear
+  int gravity_ticks_ = 0;
+  bool quick_drop_ = false;
   bool game_over_ = false;
   bool paused_ = false;
   uint64_t level_ = 1;
   uint64_t score_ = 0;
+  uint64_t pieces_ = 0;
+  uint64_t lines_ = 0;
+  uint64_t board_hash_ = 0; // Updated whenever a board cell changes
+  RowMask full_rows_ = 0; // Updated whenever a piece locks or rows clear
+
+  // Row of the topmost filled cell in each column, Board::rows if empty
+  std::array<int8_t, Board::cols> surface_;
   uint8_t level_progression_ = 0;
-  std::default_random_engine rng_;
-  WallKickTable JLTSZ_kicks_;
-  WallKickTable I_kicks_;
-  StateStack states_;
-  State state_;
+  Randomizer randomizer_;
+  PieceQueue queue_;
+  std::array<State, max_states> states_; // State stack, bottom first
+  uint8_t num_states_ = 0;
+  State state_ = State::PLAYING;
+  std::array<Garbage, max_garbage> garbage_; // Pending garbage, oldest first
+  uint8_t num_garbage_ = 0;
+  EventStream* events_ = nullptr; // Not part of the snapshot
 };
 
 
+// Plain copy of everything that changes while a game is played, so search
+// code can save and restore positions with a memcpy.
+template <typename BoardT>
+struct BasicGameSnapshot {
+  BoardT board;
+  Piece current_piece;
+  PieceQueue queue;
+  Randomizer randomizer;
+  uint64_t tick;
+  uint64_t level;
+  uint64_t score;
+  uint64_t pieces;
+  uint64_t lines;
+  uint64_t board_hash;
+  typename BoardT::RowMask full_rows;
+  std::array<int8_t, BoardT::cols> surface;
+  double step_remainder;
+  int timer;
+  int gravity_ticks;
+  bool quick_drop;
+  bool game_over;
+  bool paused;
+  uint8_t level_progression;
+  GameState state;
+  uint8_t num_states;
+  std::array<GameState, BasicGame<BoardT>::max_states> states;
+  uint8_t num_garbage;
+  std::array<Garbage, BasicGame<BoardT>::max_garbage> garbage;
+};
+
+
+using Game = BasicGame<Board>;
+using GameSnapshot = BasicGameSnapshot<Board>;
+
+static_assert(std::is_trivially_copyable_v<Game>);
+static_assert(std::is_trivially_copyable_v<GameSnapshot>);
+
+
+// Defined in game.cpp for these board sizes only
+extern template class BasicGame<Board>;
+extern template class BasicGame<TallBoard>;
+extern template class BasicGame<WideBoard>;
+
+
 } // namespace Tetris
 
 
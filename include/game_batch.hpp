@@ -0,0 +1,79 @@
+#ifndef TETRIS_GAME_BATCH_HPP_
+#define TETRIS_GAME_BATCH_HPP_
+
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "game.hpp"
+
+
+namespace Tetris {
+
+
+// What to do with one game of a batch before it is stepped
+enum class Action : uint8_t {
+  NOOP, LEFT, RIGHT, ROTATE_CW, ROTATE_CCW, SOFT_DROP, HARD_DROP
+};
+
+
+// Many games stepped in lockstep, for training agents on a large number of
+// environments at once. The games are stored contiguously, and after every
+// step their observations are written to one array per field. All memory is
+// allocated on construction.
+template <typename BoardT>
+class BasicGameBatch {
+public:
+  using Board = BoardT;
+  using Game = BasicGame<Board>;
+  using Row = typename Board::Row;
+
+  // Entry k of each array belongs to game k
+  struct Observations {
+    std::vector<Row> board; // Board::rows rows per game, without the piece
+    std::vector<uint8_t> piece; // Type of the current piece
+    std::vector<uint8_t> rotation;
+    std::vector<int8_t> row; // Origin of the current piece
+    std::vector<int8_t> col;
+    std::vector<uint8_t> queue; // PieceQueue::capacity types per game
+    std::vector<int32_t> reward; // Score gained during the last step
+    std::vector<uint8_t> done; // Set if the game ended in the last step
+  };
+
+  // Game k is seeded with config.seed + k
+  BasicGameBatch(int size, const GameConfig&);
+
+  // Apply actions[k] to game k, then advance every game by one tick. There
+  // must be an action for every game. Games that end are restarted at once,
+  // so their observation is already the start of the next game.
+  void Step(std::span<const Action> actions);
+
+  // Restart every game from its original seed
+  void Reset();
+
+  int size() const;
+  const Observations& observations() const;
+  const Game& game(int k) const;
+
+private:
+  void Observe(int k);
+
+  GameConfig config_;
+  std::vector<Game> games_;
+  Observations obs_;
+};
+
+
+using GameBatch = BasicGameBatch<Board>;
+
+
+extern template class BasicGameBatch<Board>;
+extern template class BasicGameBatch<TallBoard>;
+extern template class BasicGameBatch<WideBoard>;
+
+
+} // namespace Tetris
+
+
+#endif
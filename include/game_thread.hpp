@@ -0,0 +1,68 @@
+#ifndef TETRIS_GAME_THREAD_HPP_
+#define TETRIS_GAME_THREAD_HPP_
+
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+#include "game.hpp"
+#include "input_engine.hpp"
+#include "spsc_queue.hpp"
+
+
+namespace Tetris {
+
+
+enum class CommandType : uint8_t {
+  KEY, // A key went up or down
+  RESTART,
+  PAUSE // Toggle pause
+};
+
+
+struct Command {
+  CommandType type;
+  KeyEvent key; // Time of the command, and the key for KEY
+};
+
+
+// Runs a game in real time on its own thread, so the game advances at its
+// tick rate however long frames take to render. Commands from an input
+// thread come in through a lock-free queue and are applied at the tick
+// their timestamp falls in, with key handling done by an InputEngine. The
+// state is published every tick for a renderer to copy.
+class GameThread {
+public:
+  static double Now(); // Seconds on the clock commands are timestamped with
+
+  // Start running a copy of the game. The copy takes over the game's event
+  // stream, so the original must not be played on afterwards.
+  explicit GameThread(const Game&);
+  ~GameThread(); // Stop the thread
+  GameThread(const GameThread&) = delete;
+  GameThread& operator=(const GameThread&) = delete;
+
+  // Queue a command. Only call from one thread. Returns false if the queue
+  // is full.
+  bool Push(const Command&);
+  Game::GameSnapshot Latest() const; // Most recently published state
+
+private:
+  void Run();
+  void Publish();
+
+  Game game_;
+  InputEngine engine_;
+  SpscQueue<Command, 256> commands_;
+  mutable std::mutex mutex_; // Guards published_
+  Game::GameSnapshot published_;
+  std::atomic<bool> stop_{false};
+  std::thread thread_; // Last, so it starts after everything it uses
+};
+
+
+} // namespace Tetris
+
+
+#endif
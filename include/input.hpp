@@ -5,26 +5,26 @@
 
 #include <SDL2/SDL.h>
 
-
-namespace Tetris {
+#include "game_thread.hpp"
 
 
-class Game;
-class Renderer;
+namespace Tetris {
 
 
-// This class handles input to a Game instance.
+// This class turns SDL events into timestamped commands for a game running
+// on a GameThread. It only runs on the main thread, which SDL requires.
 class Controller {
 public:
-  Controller(Game*);
-  bool HandleInput(); // Return true if quitting
+  Controller(GameThread*);
+
+  // Forward events as they arrive until SDL_GetTicks() reaches deadline.
+  // Returns true if quitting.
+  bool HandleInput(Uint32 deadline);
 
 private:
-  void Playing(const SDL_Event&);
-  void RowClear(const SDL_Event&);
-  void Paused(const SDL_Event&);
+  void Forward(const SDL_Event&);
 
-  Game* game_;
+  GameThread* game_;
 };
 
 
@@ -0,0 +1,60 @@
+#ifndef TETRIS_INPUT_ENGINE_HPP_
+#define TETRIS_INPUT_ENGINE_HPP_
+
+
+#include <array>
+#include <cstdint>
+#include <deque>
+
+#include "game.hpp"
+
+
+namespace Tetris {
+
+
+// A key going down or up. The time is in seconds, on the same clock as
+// InputEngine::AdvanceTo().
+struct KeyEvent {
+  double time;
+  Input input;
+  bool down;
+};
+
+
+// Drives a game from timestamped key events. Every event is applied at the
+// tick its timestamp falls in, and a held LEFT or RIGHT repeats with delayed
+// auto shift and auto repeat rate from the game's config (das_ticks and
+// arr_ticks). Holding SOFT_DROP quick drops. The other inputs act once per
+// press, so OS key repeat is ignored and handling does not depend on the
+// frame rate.
+class InputEngine {
+public:
+  InputEngine(Game*, double time); // The game's current tick starts at time
+  void Push(const KeyEvent&); // Events must be pushed in time order
+
+  // Simulate the game up to time, applying the events and repeats due
+  void AdvanceTo(double time);
+
+private:
+  uint64_t TickAt(double time) const; // Ticks since start_ at time
+  void Apply(const KeyEvent&);
+  void Press(Input);
+  void Release(Input);
+  void AutoShift();
+  bool Shift(); // Move the piece in shift_ direction, false if blocked
+  bool Playing() const;
+
+  Game* game_;
+  double start_;
+  uint64_t ticks_ = 0; // Ticks simulated since start_
+  std::deque<KeyEvent> pending_;
+  std::array<bool, 6> held_{}; // Indexed by Input
+  int shift_ = 0; // Direction of auto shift, -1 left, 1 right or 0
+  int shift_ticks_ = 0; // Ticks the shift direction has been held
+};
+
+
+} // namespace Tetris
+
+
+#endif
@@ -0,0 +1,115 @@
+#ifndef TETRIS_MOVEGEN_HPP_
+#define TETRIS_MOVEGEN_HPP_
+
+
+#include <array>
+#include <bitset>
+#include <span>
+
+#include "game.hpp"
+
+
+namespace Tetris {
+
+
+// Finds every position the current piece of a Game can be locked in, using
+// the same movement and wall kick rules as the Game itself. The search is a
+// flood fill over (rotation, row, col) states that handles all rows of a
+// column at once: each state set is a bitmask of rows per rotation and
+// column, so falling, shifting and kicking are shifts and masks. Paths are
+// only searched for on request. All storage is owned by the generator and
+// reused between calls, so generating never allocates.
+template <typename BoardT>
+class BasicMoveGenerator {
+public:
+  using Board = BoardT;
+  using Game = BasicGame<Board>;
+
+  // A position where the piece rests on the stack or the floor. Placements
+  // with identical cells are only reported once.
+  struct Placement {
+    Piece piece;
+  };
+
+  static constexpr int max_path = 128;
+
+  // Inputs leading from the current piece to a placement, always ending with
+  // a hard drop. The path assumes all inputs are applied within one tick.
+  struct Path {
+    std::array<Input, max_path> inputs;
+    int size = 0;
+  };
+
+  // Search from game.current_piece. The returned placements stay valid until
+  // the next call.
+  std::span<const Placement> Generate(const Game&);
+
+  // Shortest input path to a placement from the last Generate() call. Empty
+  // in the pathological case that it needs more than max_path inputs.
+  Path GetPath(const Placement&);
+
+private:
+  static constexpr int row_bias = 3;
+  static constexpr int col_bias = 3;
+  static constexpr int num_rows = Board::rows + row_bias;
+  static constexpr int num_cols = Board::cols + col_bias;
+  static constexpr int num_states = 4*num_rows*num_cols;
+  static_assert(num_rows < 64, "rows must fit in a 64 bit column mask");
+  static_assert(num_states <= 1 << 16);
+
+  // Bit row+row_bias is set for each row in a column
+  using Column = uint64_t;
+
+  // A piece position in search coordinates
+  struct Node {
+    int8_t rotation;
+    int8_t row;
+    int8_t col;
+  };
+
+  static uint16_t Encode(int rotation, int row, int col);
+  void ComputeFits(const Board&, PieceType);
+  bool Fits(int rotation, int row, int col) const;
+  bool Rotate(Node&, int to) const;
+  void Reach(int rotation, int col, Column rows);
+  void Expand(int rotation, int col);
+  bool DirectPath(const Node& target, Path&) const;
+  bool SearchPath(const Node& target, Path&);
+
+  PieceType type_ = PieceType::I;
+  Node root_;
+
+  // Indexed by rotation and col+col_bias
+  std::array<std::array<Column, num_cols>, 4> fits_;
+  std::array<std::array<Column, num_cols>, 4> reached_;
+  std::array<std::array<Column, num_cols>, 4> expanded_;
+  std::array<std::array<Column, num_cols>, 4> placed_;
+
+  // Columns whose reached rows still need expanding
+  std::array<uint8_t, 4*num_cols> stack_;
+  std::bitset<4*num_cols> pending_;
+  int stack_size_ = 0;
+
+  std::array<Placement, num_states> placements_;
+
+  // Breadth-first search for paths
+  std::bitset<num_states> visited_;
+  std::array<uint16_t, num_states> parent_;
+  std::array<Input, num_states> input_;
+  std::array<uint8_t, num_states> depth_;
+  std::array<Node, num_states> queue_;
+};
+
+
+using MoveGenerator = BasicMoveGenerator<Board>;
+
+
+extern template class BasicMoveGenerator<Board>;
+extern template class BasicMoveGenerator<TallBoard>;
+extern template class BasicMoveGenerator<WideBoard>;
+
+
+} // namespace Tetris
+
+
+#endif
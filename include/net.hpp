@@ -0,0 +1,36 @@
+#ifndef TETRIS_NET_HPP_
+#define TETRIS_NET_HPP_
+
+
+#include <cstdint>
+#include <string>
+
+
+// Socket helpers shared by tetris_server and tetris_loadgen. All functions
+// return -1 and print the reason on failure.
+
+
+namespace Tetris {
+
+
+// A Unix domain socket if path is set, otherwise TCP on the loopback
+// interface
+struct Endpoint {
+  std::string path;
+  uint16_t port = 7000;
+};
+
+
+int Listen(const Endpoint&); // Non-blocking listening socket
+int Connect(const Endpoint&); // Non-blocking connected socket
+int SetNonBlocking(int fd);
+
+// Raise the limit on open files as far as allowed, for thousands of
+// sessions in one process
+void RaiseFileLimit();
+
+
+} // namespace Tetris
+
+
+#endif
@@ -0,0 +1,100 @@
+#ifndef TETRIS_OBSERVATION_HPP_
+#define TETRIS_OBSERVATION_HPP_
+
+
+#include <cstddef>
+#include <cstdint>
+
+#include "game.hpp"
+
+
+namespace Tetris {
+
+
+// Byte layout of an encoded observation, for feeding a game to a learning
+// agent. Offsets and sizes are in bytes.
+template <typename BoardT>
+struct ObservationLayout {
+  // One byte per cell, row-major from the top: 0 for empty, 1 for filled
+  // and 2 for the current piece
+  static constexpr int board = 0;
+  static constexpr int board_size = BoardT::rows*BoardT::cols;
+
+  // Type of the current piece
+  static constexpr int piece = board + board_size;
+
+  // Types of the queued pieces, padded with no_piece up to the capacity
+  static constexpr int queue = piece + 1;
+  static constexpr int queue_size = PieceQueue::capacity;
+
+  static constexpr int size = queue + queue_size;
+};
+
+
+constexpr uint8_t no_piece = 0xFF;
+
+
+// Write the observation of a game to out, which must hold
+// ObservationLayout<BoardT>::size bytes.
+template <typename BoardT>
+void EncodeObservation(const BasicGame<BoardT>&, uint8_t* out);
+
+
+// Memory layout of the planes written by PlaneEncoder
+enum class PlaneLayout : uint8_t {
+  PACKED_BITS, // Per plane, one Board::Row per row with bit c for column c
+  UINT8_HWC, // uint8 [rows][cols][planes], 0 or 1
+  FLOAT_CHW // float [planes][rows][cols], 0.0 or 1.0
+};
+
+
+// Encodes a game as a stack of board-sized binary planes:
+//   0: filled cells
+//   1: the current piece
+//   2: the ghost, where the current piece lands when hard dropped
+//   3 and up: one plane per queued piece, drawn at its spawn position
+// Planes for queue entries beyond the game's preview length are empty.
+template <typename BoardT>
+class PlaneEncoder {
+public:
+  using Board = BoardT;
+  using Game = BasicGame<Board>;
+
+  static constexpr int fixed_planes = 3;
+  static constexpr int max_planes = fixed_planes + PieceQueue::capacity;
+
+  // preview is the number of queue planes, clamped to the queue capacity
+  explicit PlaneEncoder(PlaneLayout, int preview = 5);
+
+  int planes() const;
+  size_t size() const; // Bytes written by Encode()
+
+  // Write the planes of a game to out, which must hold size() bytes and be
+  // aligned for the element type of the layout
+  void Encode(const Game&, void* out) const;
+
+private:
+  using Row = typename Board::Row;
+  using Planes = std::array<std::array<Row, Board::rows>, max_planes>;
+
+  void WriteBytes(const Planes&, uint8_t* out) const;
+  void WriteFloats(const Planes&, float* out) const;
+
+  PlaneLayout layout_;
+  int planes_;
+};
+
+
+extern template void EncodeObservation(const BasicGame<Board>&, uint8_t*);
+extern template void EncodeObservation(const BasicGame<TallBoard>&, uint8_t*);
+extern template void EncodeObservation(const BasicGame<WideBoard>&, uint8_t*);
+
+extern template class PlaneEncoder<Board>;
+extern template class PlaneEncoder<TallBoard>;
+extern template class PlaneEncoder<WideBoard>;
+
+
+} // namespace Tetris
+
+
+#endif
@@ -2,8 +2,8 @@
 #define TETRIS_PIECE_HPP_
 
 
-#include <vector>
-#include <utility>
+#include <array>
+#include <cstdint>
 
 #include "points.hpp"
 
@@ -11,66 +11,192 @@
 namespace Tetris {
 
 
-enum class PieceType {
+enum class PieceType : uint8_t {
   I, J, L, O, S, T, Z
 };
 
 
-// Base class for tetris pieces. We inherit from this and implement the
-// RotateCW() function to define a specific piece. Note that this class
-// inherits from Points, so we can do simple translation, e.g.: piece + {1,0}
-// to move the piece one row down.
-struct Piece : Points {
-  using Points::Points;
+// Cells of a piece relative to its origin, which is the top-left corner of
+// the piece's SRS bounding box.
+using Shape = std::array<Point, 4>;
+
+// Offsets tried in order when a rotation is blocked.
+using Kicks = std::array<Point, 4>;
+
+// Spawn orientation of each piece type within its bounding box.
+inline constexpr std::array<Shape, 7> spawn_shapes = {{
+  {{{1, 0}, {1, 1}, {1, 2}, {1, 3}}}, // I
+  {{{0, 0}, {1, 0}, {1, 1}, {1, 2}}}, // J
+  {{{1, 0}, {1, 1}, {1, 2}, {0, 2}}}, // L
+  {{{0, 0}, {0, 1}, {1, 0}, {1, 1}}}, // O
+  {{{1, 0}, {1, 1}, {0, 1}, {0, 2}}}, // S
+  {{{1, 0}, {1, 1}, {1, 2}, {0, 1}}}, // T
+  {{{0, 0}, {0, 1}, {1, 1}, {1, 2}}}, // Z
+}};
+
+// Side length of the bounding box each piece rotates in.
+inline constexpr std::array<int, 7> box_sizes = {4, 3, 3, 2, 3, 3, 3};
+
+// SRS wall kicks for the clockwise rotation out of each rotation state, as
+// {row, col} offsets with rows growing downwards.
+inline constexpr std::array<Kicks, 4> JLTSZ_kicks = {{
+  {{{0, -1}, {-1, -1}, { 2, 0}, { 2, -1}}},
+  {{{0,  1}, { 1,  1}, {-2, 0}, {-2,  1}}},
+  {{{0,  1}, {-1,  1}, { 2, 0}, { 2,  1}}},
+  {{{0, -1}, { 1, -1}, {-2, 0}, {-2, -1}}},
+}};
+
+inline constexpr std::array<Kicks, 4> I_kicks = {{
+  {{{0, -2}, { 0,  1}, { 1, -2}, {-2,  1}}},
+  {{{0, -1}, { 0,  2}, {-2, -1}, { 1,  2}}},
+  {{{0,  2}, { 0, -1}, {-1,  2}, { 2, -1}}},
+  {{{0,  1}, { 0, -2}, { 2,  1}, {-1, -2}}},
+}};
+
+
+// piece_shapes[type][rotation] holds the cells of every piece orientation,
+// generated by rotating the spawn shape clockwise within its bounding box.
+constexpr auto MakePieceShapes() {
+  std::array<std::array<Shape, 4>, 7> shapes{};
+
+  for (int type = 0; type < 7; ++type) {
+    const int n = box_sizes[type];
+    shapes[type][0] = spawn_shapes[type];
+
+    for (int rotation = 1; rotation < 4; ++rotation) {
+      for (int i = 0; i < 4; ++i) {
+        const Point p = shapes[type][rotation-1][i];
+        shapes[type][rotation][i] = {p.col, n-1-p.row};
+      }
+    }
+  }
+
+  return shapes;
+}
+
+inline constexpr auto piece_shapes = MakePieceShapes();
+
+
+// wall_kicks[type][from][to] holds the kicks for rotating from one state to
+// an adjacent one. Counter-clockwise kicks are the negated clockwise kicks of
+// the reverse rotation. The O piece never needs kicking.
+constexpr auto MakeWallKicks() {
+  std::array<std::array<std::array<Kicks, 4>, 4>, 7> kicks{};
+
+  for (int type = 0; type < 7; ++type) {
+    if (type == static_cast<int>(PieceType::O)) { continue; }
+
+    const auto& cw = type == static_cast<int>(PieceType::I) ?
+      I_kicks : JLTSZ_kicks;
+
+    for (int from = 0; from < 4; ++from) {
+      const int to = (from+1) % 4;
+      for (int i = 0; i < 4; ++i) {
+        const Point k = cw[from][i];
+        kicks[type][from][to][i] = k;
+        kicks[type][to][from][i] = {-k.row, -k.col};
+      }
+    }
+  }
+
+  return kicks;
+}
+
+inline constexpr auto wall_kicks = MakeWallKicks();
+
+
+// Bitmask form of a piece orientation: bit c of rows[i] is set if the cell
+// at (i, c) of the bounding box is filled. The remaining fields give the
+// extent of the filled cells within the box, and the lowest filled row of
+// each box column (-1 for empty columns).
+struct ShapeMask {
+  std::array<uint16_t, 4> rows;
+  int top;
+  int bottom;
+  int left;
+  int right;
+  std::array<int, 4> col_bottom;
+};
 
-  virtual void RotateCW() = 0;
-  void RotateCCW();
 
-  int rotation = 0;
-  PieceType type;
-};
+constexpr auto MakeShapeMasks() {
+  std::array<std::array<ShapeMask, 4>, 7> masks{};
 
+  for (int type = 0; type < 7; ++type) {
+    for (int rotation = 0; rotation < 4; ++rotation) {
+      auto& m = masks[type][rotation];
+      m = {{}, 3, 0, 3, 0, {-1, -1, -1, -1}};
 
-struct IPiece : public Piece {
-  IPiece();
-  void RotateCW() override;
-};
+      for (const auto& p : piece_shapes[type][rotation]) {
+        m.rows[p.row] |= 1 << p.col;
+        m.col_bottom[p.col] = p.row > m.col_bottom[p.col] ?
+          p.row : m.col_bottom[p.col];
+        m.top = p.row < m.top ? p.row : m.top;
+        m.bottom = p.row > m.bottom ? p.row : m.bottom;
+        m.left = p.col < m.left ? p.col : m.left;
+        m.right = p.col > m.right ? p.col : m.right;
+      }
+    }
+  }
 
+  return masks;
+}
 
-struct LPiece : public Piece {
-  LPiece();
-  void RotateCW() override;
-};
+inline constexpr auto shape_masks = MakeShapeMasks();
 
 
-struct JPiece : public Piece {
-  JPiece();
-  void RotateCW() override;
-};
+// A tetris piece, stored as a plain value: the type, rotation state and the
+// origin of its bounding box. The cells are looked up in piece_shapes, and
+// translating the piece, e.g.: piece += {1,0}, moves it one row down.
+struct Piece {
+  static Piece Spawn(PieceType, int board_cols);
 
+  Points cells() const;
+  const ShapeMask& mask() const;
 
-struct OPiece : public Piece {
-  OPiece();
-  void RotateCW() override;
-};
+  void RotateCW();
+  void RotateCCW();
+  void Rotate(int to); // Set rotation state directly, keeping the origin
 
+  Piece& operator+=(const int(&rhs)[2]);
 
-struct SPiece : public Piece {
-  SPiece();
-  void RotateCW() override;
+  PieceType type = PieceType::I;
+  uint8_t rotation = 0;
+  Point origin;
 };
 
 
-struct TPiece : public Piece {
-  TPiece();
-  void RotateCW() override;
-};
+inline Points Piece::cells() const {
+  const auto& shape = piece_shapes[static_cast<int>(type)][rotation];
+  return {{origin + shape[0], origin + shape[1],
+           origin + shape[2], origin + shape[3]}};
+}
 
 
-struct ZPiece : public Piece {
-  ZPiece();
-  void RotateCW() override;
-};
+inline const ShapeMask& Piece::mask() const {
+  return shape_masks[static_cast<int>(type)][rotation];
+}
+
+
+inline void Piece::RotateCW() {
+  Rotate((rotation+1) % 4);
+}
+
+
+inline void Piece::RotateCCW() {
+  Rotate((rotation+3) % 4);
+}
+
+
+inline void Piece::Rotate(int to) {
+  rotation = to;
+}
+
+
+inline Piece& Piece::operator+=(const int(&rhs)[2]) {
+  origin += rhs;
+  return *this;
+}
 
 
 } // namespace Tetris
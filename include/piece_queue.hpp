@@ -0,0 +1,70 @@
+#ifndef TETRIS_PIECE_QUEUE_HPP_
+#define TETRIS_PIECE_QUEUE_HPP_
+
+
+#include <array>
+#include <cstdint>
+
+#include "piece.hpp"
+
+
+namespace Tetris {
+
+
+// Upcoming pieces, stored in a fixed-size ring buffer. Index 0 is the piece
+// that spawns next.
+class PieceQueue {
+public:
+  static constexpr int capacity = 8;
+
+  int size() const;
+  PieceType operator[](int i) const;
+
+  void Push(PieceType);
+  PieceType Pop();
+  void Clear();
+
+private:
+  static constexpr int mask = capacity - 1;
+  static_assert((capacity & mask) == 0, "capacity must be a power of two");
+
+  std::array<PieceType, capacity> pieces_;
+  uint8_t head_ = 0;
+  uint8_t size_ = 0;
+};
+
+
+inline int PieceQueue::size() const {
+  return size_;
+}
+
+
+inline PieceType PieceQueue::operator[](int i) const {
+  return pieces_[(head_ + i) & mask];
+}
+
+
+inline void PieceQueue::Push(PieceType type) {
+  pieces_[(head_ + size_) & mask] = type;
+  size_ += 1;
+}
+
+
+inline PieceType PieceQueue::Pop() {
+  const auto type = pieces_[head_];
+  head_ = (head_ + 1) & mask;
+  size_ -= 1;
+  return type;
+}
+
+
+inline void PieceQueue::Clear() {
+  head_ = 0;
+  size_ = 0;
+}
+
+
+} // namespace Tetris
+
+
+#endif
@@ -11,14 +11,19 @@ struct Point {
   int row = 0;
   int col = 0;
 
-  Point operator+(const int (&rhs)[2]) {
+  constexpr Point operator+(const int (&rhs)[2]) const {
     return { row+rhs[0], col+rhs[1] };
   }
 
-  Point& operator+=(const int (&rhs)[2]) {
-    *this = *this + rhs;
+  constexpr Point& operator+=(const int (&rhs)[2]) {
+    row += rhs[0];
+    col += rhs[1];
     return *this;
   }
+
+  constexpr Point operator+(const Point& rhs) const {
+    return { row+rhs.row, col+rhs.col };
+  }
 };
 
 
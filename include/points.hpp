@@ -2,7 +2,7 @@
 #define TETRIS_POINTS_HPP_
 
 
-#include <vector>
+#include <array>
 
 #include "point.hpp"
 
@@ -10,21 +10,20 @@
 namespace Tetris {
 
 
-// Represents a set of points on the playfield. Note that we can translate the
-// points conveniently, e.g.: points + {1,1}
-struct Points : std::vector<Point> {
-  using std::vector<Point>::vector;
-
-  Points operator+(const int(&rhs)[2]) {
+// Represents the four cells of a tetromino on the playfield. Storage is a
+// fixed-size array, so copying and translating never allocates. Note that we
+// can translate the points conveniently, e.g.: points + {1,1}
+struct Points : std::array<Point, 4> {
+  constexpr Points operator+(const int(&rhs)[2]) const {
     Points sum = *this;
-    for (auto& p : sum) {
-      p += rhs;
-    }
+    sum += rhs;
     return sum;
   }
 
-  Points& operator+=(const int(&rhs)[2]) {
-    *this = *this + rhs;
+  constexpr Points& operator+=(const int(&rhs)[2]) {
+    for (auto& p : *this) {
+      p += rhs;
+    }
     return *this;
   }
 };
@@ -0,0 +1,73 @@
+#ifndef TETRIS_PROTOCOL_HPP_
+#define TETRIS_PROTOCOL_HPP_
+
+
+#include <bit>
+#include <cstdint>
+
+#include "game.hpp"
+#include "game_batch.hpp"
+
+
+// Wire format between tetris_server and its clients. Both directions are a
+// stream of fixed-size little-endian structs sent back to back, so a message
+// is read by copying its bytes. Every request gets exactly one response, in
+// order.
+
+
+namespace Tetris {
+
+
+static_assert(std::endian::native == std::endian::little,
+              "the protocol structs are sent as they are in memory");
+
+
+enum class RequestKind : uint8_t {
+  RESET, // Start a new game from seed
+  STEP // Apply action, then advance the game by ticks
+};
+
+
+struct Request {
+  RequestKind kind;
+  Action action;
+  uint16_t ticks;
+  uint32_t sequence; // Echoed in the response
+  uint64_t seed;
+};
+
+
+// Reply to a request, describing the game after it. The board is sent as a
+// delta: the response is followed by num_rows RowUpdates for the rows that
+// changed since the previous response. A RESET starts from an empty board.
+struct Response {
+  uint32_t sequence;
+  uint32_t reward; // Score gained during the request
+  GameState state; // GAMEOVER from the step that tops out. Further steps
+                   // do nothing until a RESET.
+  PieceType piece;
+  uint8_t rotation;
+  int8_t row;
+  int8_t col;
+  PieceType next; // First piece in the queue
+  uint8_t lines; // Rows cleared during the request
+  uint8_t num_rows;
+};
+
+
+struct RowUpdate {
+  uint8_t row;
+  uint8_t unused = 0;
+  Board::Row cells; // Bit c set for a filled cell in column c
+};
+
+
+static_assert(sizeof(Request) == 16);
+static_assert(sizeof(Response) == 16);
+static_assert(sizeof(RowUpdate) == 4);
+
+
+} // namespace Tetris
+
+
+#endif
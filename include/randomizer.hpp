@@ -0,0 +1,49 @@
+#ifndef TETRIS_RANDOMIZER_HPP_
+#define TETRIS_RANDOMIZER_HPP_
+
+
+#include <cstdint>
+
+#include "piece.hpp"
+
+
+namespace Tetris {
+
+
+// xoshiro128** pseudo random number generator. The whole state is 16 bytes
+// of plain data, so it can be copied, stored and restored freely.
+struct Rng {
+  void Seed(uint64_t seed);
+  uint32_t Next();
+  uint32_t Below(uint32_t n); // Uniform in [0, n)
+
+  uint32_t state[4];
+};
+
+
+enum class RandomizerPolicy : uint8_t {
+  UNIFORM, // Every piece is drawn independently
+  BAG, // Each group of seven pieces is a shuffled set of all seven types
+  HISTORY // Reroll pieces found among the last four, as in TGM
+};
+
+
+// Generates the sequence of pieces from a seed. Like Rng, the state is plain
+// data, and a copy continues the exact same sequence.
+struct Randomizer {
+  void Seed(uint64_t seed, RandomizerPolicy);
+  PieceType Next();
+
+  Rng rng;
+  RandomizerPolicy policy;
+  uint8_t bag_size; // Pieces left in the bag
+  uint8_t bag[7];
+  uint8_t history[4]; // Most recent piece first
+  bool first; // The first HISTORY piece is never S, Z or O
+};
+
+
+} // namespace Tetris
+
+
+#endif
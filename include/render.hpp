@@ -30,8 +30,8 @@ private:
   const Game& game_;
   const int dx_ = 25;
   const int dy_ = 25;
-  const int width_ = 18*dx_;
-  const int height_ = 24*dy_;
+  const int width_ = (Board::cols + 8)*dx_; // Grid plus the side panel
+  const int height_ = Board::rows*dy_;
 
   SDL_Window* window_;
   SDL_Renderer* renderer_;
@@ -41,8 +41,8 @@ public:
 private:
   const int dx_ = 25;
   const int dy_ = 25;
-  const int grid_width_ = 10*dx_;
-  const int grid_height_ = 24*dy_;
+  const int grid_width_ = Board::cols*dx_;
+  const int grid_height_ = Board::rows*dy_;
 };
 
 
@@ -85,7 +85,7 @@ public:
 
 private:
   Uint64 ticks_;
-  std::vector<int> rows_cleared_;
+  Game::RowMask rows_cleared_;
 };
 
 
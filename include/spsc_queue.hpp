@@ -0,0 +1,61 @@
+#ifndef TETRIS_SPSC_QUEUE_HPP_
+#define TETRIS_SPSC_QUEUE_HPP_
+
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+
+namespace Tetris {
+
+
+// Bounded ring buffer with one producer thread and one consumer thread.
+// Each side only writes its own index and reads the other's, so neither
+// takes a lock or waits.
+template <typename T, uint64_t Capacity>
+class SpscQueue {
+public:
+  static constexpr uint64_t capacity = Capacity;
+
+  bool Push(const T&); // Producer only. Returns false if the queue is full.
+  bool Pop(T&); // Consumer only. Returns false if the queue is empty.
+
+private:
+  static constexpr uint64_t mask = capacity - 1;
+  static_assert((capacity & mask) == 0, "capacity must be a power of two");
+
+  alignas(64) std::atomic<uint64_t> head_{0}; // Next item to pop
+  alignas(64) std::atomic<uint64_t> tail_{0}; // Next item to push
+  alignas(64) std::array<T, capacity> items_;
+};
+
+
+template <typename T, uint64_t Capacity>
+bool SpscQueue<T, Capacity>::Push(const T& item) {
+  const auto tail = tail_.load(std::memory_order_relaxed);
+  if (tail - head_.load(std::memory_order_acquire) == capacity) {
+    return false;
+  }
+
+  items_[tail & mask] = item;
+  tail_.store(tail + 1, std::memory_order_release);
+  return true;
+}
+
+
+template <typename T, uint64_t Capacity>
+bool SpscQueue<T, Capacity>::Pop(T& item) {
+  const auto head = head_.load(std::memory_order_relaxed);
+  if (head == tail_.load(std::memory_order_acquire)) { return false; }
+
+  item = items_[head & mask];
+  head_.store(head + 1, std::memory_order_release);
+  return true;
+}
+
+
+} // namespace Tetris
+
+
+#endif
@@ -0,0 +1,156 @@
+#ifndef TETRIS_H_
+#define TETRIS_H_
+
+/*
+ * C interface to the game engine, for driving games from other languages.
+ * A game is created once and then reset and stepped any number of times
+ * without allocating. Every game is independent, so separate games may be
+ * used from separate threads.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+#if defined(_WIN32)
+#  define TETRIS_API __declspec(dllexport)
+#elif defined(__GNUC__)
+#  define TETRIS_API __attribute__((visibility("default")))
+#else
+#  define TETRIS_API
+#endif
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* Bumped whenever a change to this header breaks existing callers */
+#define TETRIS_API_VERSION 1
+
+#define TETRIS_ROWS 24
+#define TETRIS_COLS 10
+#define TETRIS_QUEUE_SIZE 8
+
+/*
+ * Observation layout, one byte per entry:
+ *  - TETRIS_ROWS*TETRIS_COLS board cells, row-major from the top. 0 is
+ *    empty, 1 is filled and 2 is the current piece.
+ *  - The current piece type, 0-6 for I, J, L, O, S, T, Z.
+ *  - TETRIS_QUEUE_SIZE upcoming piece types, padded with TETRIS_NO_PIECE.
+ */
+#define TETRIS_OBS_BOARD 0
+#define TETRIS_OBS_PIECE (TETRIS_ROWS*TETRIS_COLS)
+#define TETRIS_OBS_QUEUE (TETRIS_OBS_PIECE + 1)
+#define TETRIS_OBS_SIZE (TETRIS_OBS_QUEUE + TETRIS_QUEUE_SIZE)
+#define TETRIS_NO_PIECE 0xFF
+
+
+typedef struct tetris_game tetris_game;
+
+
+typedef enum tetris_action {
+  TETRIS_NOOP,
+  TETRIS_LEFT,
+  TETRIS_RIGHT,
+  TETRIS_ROTATE_CW,
+  TETRIS_ROTATE_CCW,
+  TETRIS_SOFT_DROP,
+  TETRIS_HARD_DROP,
+  TETRIS_NUM_ACTIONS
+} tetris_action;
+
+
+typedef struct tetris_step_result {
+  int64_t reward; /* Score gained during the step */
+  int32_t lines; /* Rows cleared during the step */
+  int32_t done; /* Nonzero once the game is over */
+} tetris_step_result;
+
+
+TETRIS_API int tetris_api_version(void);
+
+/* Create a game at 60 ticks per second. Returns NULL if out of memory. */
+TETRIS_API tetris_game* tetris_create(uint64_t seed);
+TETRIS_API void tetris_destroy(tetris_game*);
+
+/* Start a new game whose piece sequence is determined by seed */
+TETRIS_API void tetris_reset(tetris_game*, uint64_t seed);
+
+/* Apply an action, then advance the game by one tick. Unknown actions are
+   treated as TETRIS_NOOP. */
+TETRIS_API tetris_step_result tetris_step(tetris_game*, int action);
+
+/* Write the current observation to obs, which must hold TETRIS_OBS_SIZE
+   bytes */
+TETRIS_API void tetris_observe(const tetris_game*, uint8_t* obs);
+
+TETRIS_API uint64_t tetris_score(const tetris_game*);
+TETRIS_API uint64_t tetris_lines(const tetris_game*);
+TETRIS_API uint64_t tetris_pieces(const tetris_game*);
+
+
+/*
+ * Board-shaped binary planes: filled cells, the current piece, its ghost,
+ * then one plane per queued piece at its spawn position. preview is the
+ * number of queue planes, at most TETRIS_QUEUE_SIZE.
+ */
+typedef enum tetris_plane_layout {
+  TETRIS_PLANES_PACKED, /* uint16_t [planes][rows], bit c for column c */
+  TETRIS_PLANES_UINT8_HWC, /* uint8_t [rows][cols][planes] */
+  TETRIS_PLANES_FLOAT_CHW /* float [planes][rows][cols] */
+} tetris_plane_layout;
+
+
+/* Bytes written by tetris_observe_planes with the same arguments */
+TETRIS_API size_t tetris_planes_size(int layout, int preview);
+
+/* Write the planes of a game to out, which must hold tetris_planes_size
+   bytes and be aligned for the element type of the layout */
+TETRIS_API void tetris_observe_planes(
+    const tetris_game*, int layout, int preview, void* out);
+
+
+/*
+ * Batches step many games with one call and write their observations into
+ * one array per field, with entry k belonging to game k. Games that end are
+ * restarted within the step, and their done flag is set.
+ */
+typedef struct tetris_batch tetris_batch;
+
+
+typedef struct tetris_batch_obs {
+  const uint16_t* board; /* TETRIS_ROWS rows per game, bit c set for column c */
+  const uint8_t* piece; /* Type of the current piece */
+  const uint8_t* rotation;
+  const int8_t* row; /* Origin of the current piece */
+  const int8_t* col;
+  const uint8_t* queue; /* TETRIS_QUEUE_SIZE types per game */
+  const int32_t* reward; /* Score gained during the last step */
+  const uint8_t* done; /* Nonzero if the game ended in the last step */
+} tetris_batch_obs;
+
+
+/* Create size games, game k seeded with seed + k. Returns NULL if size is
+   not positive or out of memory. */
+TETRIS_API tetris_batch* tetris_batch_create(int size, uint64_t seed);
+TETRIS_API void tetris_batch_destroy(tetris_batch*);
+
+/* Restart every game from its original seed */
+TETRIS_API void tetris_batch_reset(tetris_batch*);
+
+/* Apply actions[k], a tetris_action, to game k, then advance every game by
+   one tick */
+TETRIS_API void tetris_batch_step(tetris_batch*, const uint8_t* actions);
+
+/* The arrays stay valid and in place until the batch is destroyed */
+TETRIS_API tetris_batch_obs tetris_batch_observations(const tetris_batch*);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef TETRIS_VERSUS_HPP_
+#define TETRIS_VERSUS_HPP_
+
+
+#include <array>
+#include <cstdint>
+
+#include "game.hpp"
+#include "randomizer.hpp"
+
+
+namespace Tetris {
+
+
+// Where the holes of a garbage attack go
+enum class GarbageHoles : uint8_t {
+  CLEAN, // All rows of one attack share a random hole column
+  MESSY // Every row gets its own random hole column, as long as the pending
+        // garbage fits on the board (see BasicGame::max_garbage)
+};
+
+
+struct VersusConfig {
+  GameConfig game; // Used by both players, so both get the same pieces
+  GarbageHoles holes = GarbageHoles::CLEAN;
+
+  // Garbage rows sent for clearing 0 to 4 rows at once
+  std::array<uint8_t, 5> attack = {0, 0, 1, 2, 4};
+};
+
+
+// Two games played against each other. Rows cleared by one player become
+// garbage for the other, after first cancelling the player's own pending
+// garbage and any attack the other player makes in the same tick.
+// Everything, including the hole positions, follows from the seed in the
+// config, so a match replays exactly given the same inputs.
+template <typename BoardT>
+class BasicVersus {
+public:
+  using Board = BoardT;
+  using Game = BasicGame<Board>;
+
+  explicit BasicVersus(const VersusConfig&);
+
+  // Advance both games by one tick and exchange garbage. Does nothing once
+  // the match is over.
+  void Tick();
+  void Restart();
+
+  bool over() const; // Set once either player has topped out
+  int winner() const; // 0 or 1, or -1 if the match is running or drawn
+  uint64_t sent(int player) const; // Garbage rows sent by the player
+
+  std::array<Game, 2> games;
+
+private:
+  void ResetMatch();
+  void Send(int from, int rows);
+
+  VersusConfig config_;
+  Rng rng_;
+  std::array<uint64_t, 2> lines_;
+  std::array<uint64_t, 2> sent_;
+};
+
+
+using Versus = BasicVersus<Board>;
+
+
+extern template class BasicVersus<Board>;
+extern template class BasicVersus<TallBoard>;
+extern template class BasicVersus<WideBoard>;
+
+
+} // namespace Tetris
+
+
+#endif
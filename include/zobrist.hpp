@@ -0,0 +1,82 @@
+#ifndef TETRIS_ZOBRIST_HPP_
+#define TETRIS_ZOBRIST_HPP_
+
+
+#include <bit>
+#include <cstdint>
+
+#include "board.hpp"
+#include "piece.hpp"
+
+
+namespace Tetris {
+
+
+// Random keys for Zobrist hashing of a board and the current piece. A filled
+// cell contributes its key, and a piece contributes the keys of its type and
+// rotation, origin row and origin column. The keys are generated at compile
+// time with splitmix64, so hashes are stable across builds.
+template <typename BoardT>
+struct ZobristKeys {
+  static constexpr int origin_bias = 3; // Piece origins can be left of col 0
+
+  uint64_t cells[BoardT::rows][BoardT::cols];
+  uint64_t piece[7][4];
+  uint64_t piece_row[BoardT::rows + origin_bias];
+  uint64_t piece_col[BoardT::cols + origin_bias];
+};
+
+
+template <typename BoardT>
+constexpr ZobristKeys<BoardT> MakeZobristKeys() {
+  uint64_t state = 0x5A0B1257u;
+  auto next = [&state] {
+    uint64_t z = (state += 0x9E3779B97F4A7C15u);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9u;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBu;
+    return z ^ (z >> 31);
+  };
+
+  ZobristKeys<BoardT> keys{};
+  for (auto& row : keys.cells) {
+    for (auto& key : row) { key = next(); }
+  }
+  for (auto& type : keys.piece) {
+    for (auto& key : type) { key = next(); }
+  }
+  for (auto& key : keys.piece_row) { key = next(); }
+  for (auto& key : keys.piece_col) { key = next(); }
+
+  return keys;
+}
+
+template <typename BoardT>
+inline constexpr ZobristKeys<BoardT> zobrist_keys = MakeZobristKeys<BoardT>();
+
+
+// Hash of the given cells of one board row
+template <typename BoardT>
+uint64_t ZobristRow(int row, typename BoardT::Row cells) {
+  uint64_t hash = 0;
+  while (cells) {
+    hash ^= zobrist_keys<BoardT>.cells[row][std::countr_zero(cells)];
+    cells &= cells - 1;
+  }
+  return hash;
+}
+
+
+template <typename BoardT>
+uint64_t ZobristPiece(const Piece& piece) {
+  const auto& keys = zobrist_keys<BoardT>;
+  const auto bias = ZobristKeys<BoardT>::origin_bias;
+  return keys.piece[static_cast<int>(piece.type)][piece.rotation] ^
+         keys.piece_row[piece.origin.row + bias] ^
+         keys.piece_col[piece.origin.col + bias];
+}
+
+
+} // namespace Tetris
+
+
+#endif
@@ -0,0 +1,125 @@
+#include "agent.hpp"
+
+#include <cstdlib>
+
+
+namespace Tetris {
+
+
+// RandomAgent
+RandomAgent::RandomAgent(uint64_t seed) : rng_(seed) {}
+
+
+void RandomAgent::Act(Game& game) {
+  // state() only leaves PLAYING a tick after a lock completes rows or tops
+  // out, so wait for those rows to clear before planning the next piece
+  if (game.state() != Game::State::PLAYING || game.FullRows() != 0 ||
+      game.game_over()) {
+    return;
+  }
+
+  // Only act once per piece
+  if (game.pieces() == placed_) { return; }
+  placed_ = game.pieces();
+
+  std::uniform_int_distribution<int> rotations{0, 3};
+  std::uniform_int_distribution<int> shift{-Board::cols/2, Board::cols/2};
+
+  for (int i = rotations(rng_); i > 0; --i) {
+    game.RotatePiece();
+  }
+
+  const int dx = shift(rng_);
+  for (int i = 0; i < dx; ++i) {
+    game.MovePieceRight();
+  }
+  for (int i = 0; i > dx; --i) {
+    game.MovePieceLeft();
+  }
+
+  game.HardDrop();
+}
+
+
+// GreedyAgent
+void GreedyAgent::Act(Game& game) {
+  if (game.state() != Game::State::PLAYING || game.FullRows() != 0 ||
+      game.game_over()) {
+    return;
+  }
+
+  if (game.pieces() == placed_) { return; }
+  placed_ = game.pieces();
+
+  const MoveGenerator::Placement* best = nullptr;
+  double best_score = 0.0;
+  for (const auto& placement : generator_.Generate(game)) {
+    Board board = game.board;
+    for (const auto& p : placement.piece.cells()) {
+      board.Fill(p.row, p.col);
+    }
+
+    const double score = Evaluate(board);
+    if (!best || score > best_score) {
+      best = &placement;
+      best_score = score;
+    }
+  }
+
+  if (!best) { return; }
+
+  const auto path = generator_.GetPath(*best);
+  for (int i = 0; i < path.size; ++i) {
+    game.Apply(path.inputs[i]);
+  }
+}
+
+
+double GreedyAgent::Evaluate(Board board) {
+  // Rows drop by the number of full rows below them once those are cleared
+  int lines = 0;
+  int drop[Board::rows];
+  for (int row = board.rows-1; row >= 0; --row) {
+    drop[row] = lines;
+    lines += board.RowIsFull(row);
+  }
+
+  int heights[Board::cols] = {};
+  int holes = 0;
+  for (int row = 0; row < board.rows; ++row) {
+    if (board.RowIsFull(row)) { continue; }
+
+    for (int col = 0; col < board.cols; ++col) {
+      if (board.Filled(row, col)) {
+        if (heights[col] == 0) { heights[col] = board.rows-row-drop[row]; }
+      } else if (heights[col] > 0) {
+        holes += 1;
+      }
+    }
+  }
+
+  int height = 0;
+  int bumpiness = 0;
+  for (int col = 0; col < board.cols; ++col) {
+    height += heights[col];
+    if (col > 0) { bumpiness += std::abs(heights[col] - heights[col-1]); }
+  }
+
+  return -0.51*height + 0.76*lines - 0.36*holes - 0.18*bumpiness;
+}
+
+
+std::unique_ptr<Agent> MakeAgent(const std::string& name, uint64_t seed) {
+  if (name == "random") {
+    return std::make_unique<RandomAgent>(seed);
+  }
+
+  if (name == "greedy") {
+    return std::make_unique<GreedyAgent>();
+  }
+
+  return nullptr;
+}
+
+
+} // namespace Tetris
@@ -1,133 +1,199 @@
 #include "game.hpp"
 
 #include <algorithm>
+#include <bit>
+#include <cmath>
 #include <cstdlib>
 #include <chrono>
 
 #include "piece.hpp"
+#include "zobrist.hpp"
 
 namespace Tetris {
 
 
-Game::Game() {
-  unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
-  rng_.seed(seed);
+GameConfig GameConfig::WithTickRate(int tick_rate) {
+  const GameConfig defaults;
+  auto scale = [&] (int ticks) { // Rounded to the nearest tick
+    const int rate = defaults.tick_rate;
+    return std::max(1, (ticks*tick_rate + rate/2) / rate);
+  };
 
-  current_piece = GetRandomPiece();
-  next_piece = GetRandomPiece();
-  board.Clear();
+  GameConfig config;
+  config.tick_rate = tick_rate;
+  config.gravity_ticks = scale(defaults.gravity_ticks);
+  config.quick_drop_ticks = scale(defaults.quick_drop_ticks);
+  config.row_clear_ticks = scale(defaults.row_clear_ticks);
+  config.das_ticks = scale(defaults.das_ticks);
+  config.arr_ticks = scale(defaults.arr_ticks);
+  return config;
+}
 
-  JLTSZ_kicks_ = {{{0, -1}, {-1, -1}, { 2, 0}, { 2, -1}},
-                  {{0,  1}, { 1,  1}, {-2, 0}, {-2,  1}},
-                  {{0,  1}, {-1,  1}, { 2, 0}, { 2,  1}},
-                  {{0, -1}, { 1, -1}, {-2, 0}, {-2, -1}}};
 
-  I_kicks_ = {{{0, -2}, { 0,  1}, { 1, -2}, {-2,  1}},
-              {{0, -1}, { 0,  2}, {-2, -1}, { 1,  2}},
-              {{0,  2}, { 0, -1}, {-1,  2}, { 2, -1}},
-              {{0,  1}, { 0, -2}, { 2,  1}, {-1, -2}}};
+template <typename BoardT>
+BasicGame<BoardT>::BasicGame() : BasicGame([] {
+  Config config;
+  config.seed = std::chrono::system_clock::now().time_since_epoch().count();
+  return config;
+}()) {}
 
-  states_.push_back(&Game::PlayingStep);
+
+template <typename BoardT>
+BasicGame<BoardT>::BasicGame(const Config& config) : config_{config} {
+  config_.preview = std::clamp(config_.preview, 1, PieceQueue::capacity);
+  randomizer_.Seed(config_.seed, config_.randomizer);
+  Restart();
 }
 
 
-void Game::Step(double dt) {
-  auto step = states_.back();
-  step(this, dt);
+template <typename BoardT>
+void BasicGame<BoardT>::Tick() {
+  switch (states_[num_states_-1]) {
+    case State::PLAYING:
+      PlayingStep();
+      break;
+    case State::PAUSED:
+      PausedStep();
+      break;
+    case State::ROWCLEAR:
+      RowClearStep();
+      break;
+    case State::GAMEOVER:
+      GameOverStep();
+      break;
+  }
+
+  tick_ += 1;
 }
 
 
-void Game::QuickDrop(bool q) {
-  if (q) {
-    pause_time_ = 0.05;
-  }
-  else {
-    pause_time_ = std::pow(0.9, level_-1);
+template <typename BoardT>
+void BasicGame<BoardT>::PushState(State state) {
+  if (num_states_ < max_states) {
+    states_[num_states_++] = state;
   }
 }
 
-uint64_t Game::score() const { return score_; }
-uint64_t Game::level() const { return level_; }
 
+template <typename BoardT>
+void BasicGame<BoardT>::PopState() {
+  num_states_ -= 1;
+}
 
-Game::RowIndices Game::GetFullRows() const {
-  RowIndices idxs;
 
-  for (int i = 0; i < board.rows; ++i) {
-    if (RowIsFull(i)) {
-      idxs.push_back(i);
-    }
+template <typename BoardT>
+void BasicGame<BoardT>::Step(double dt) {
+  step_remainder_ += dt*config_.tick_rate;
+  while (step_remainder_ >= 1.0) {
+    Tick();
+    step_remainder_ -= 1.0;
   }
+}
+
+
+template <typename BoardT>
+void BasicGame<BoardT>::QuickDrop(bool q) {
+  quick_drop_ = q;
+}
 
-  return idxs;
+template <typename BoardT>
+uint64_t BasicGame<BoardT>::score() const { return score_; }
+template <typename BoardT>
+uint64_t BasicGame<BoardT>::level() const { return level_; }
+template <typename BoardT>
+uint64_t BasicGame<BoardT>::pieces() const { return pieces_; }
+template <typename BoardT>
+uint64_t BasicGame<BoardT>::lines() const { return lines_; }
+template <typename BoardT>
+uint64_t BasicGame<BoardT>::tick() const { return tick_; }
+
+
+template <typename BoardT>
+uint64_t BasicGame<BoardT>::hash() const {
+  return board_hash_ ^ ZobristPiece<BoardT>(current_piece);
 }
 
+template <typename BoardT>
+const GameConfig& BasicGame<BoardT>::config() const { return config_; }
+template <typename BoardT>
+const PieceQueue& BasicGame<BoardT>::queue() const { return queue_; }
 
-void Game::PlayingStep(double dt) {
+
+template <typename BoardT>
+auto BasicGame<BoardT>::FullRows() const -> RowMask {
+  return full_rows_;
+}
+
+
+template <typename BoardT>
+void BasicGame<BoardT>::PlayingStep() {
   state_ = State::PLAYING;
 
   // If paused, transition to PausedStep
   if (paused_) {
-    states_.push_back(&Game::PausedStep);
+    PushState(State::PAUSED);
   }
 
   // If game over, transition to GameOverStep
   if (game_over_) {
-    states_.push_back(&Game::GameOverStep);
+    PushState(State::GAMEOVER);
   }
 
-  time_ += dt;
-  if (time_ < pause_time_) { return; }
+  timer_ += 1;
+  if (timer_ < DropTicks()) { return; }
 
-  *current_piece += {1, 0};
+  current_piece += {1, 0};
 
   // Spawn new piece if we've hit something
-  auto HitSomething = [this] (Point p) {
-    return p.row >= board.rows || board.matrix[p.row][p.col] != 0; };
-  if (std::ranges::any_of(*current_piece, HitSomething)) {
-    *current_piece += {-1, 0};
+  if (!ValidPosition(current_piece)) {
+    current_piece += {-1, 0};
     LockPieceAndSpawnNew();
+  } else {
+    Emit(EventType::MOVE);
   }
 
   CheckGameOver();
 
-  time_ = 0.0;
+  timer_ = 0;
 
   // If any row is full, transition to RowClearStep
-  if (GetFullRows().size() > 0) {
-    states_.push_back(&Game::RowClearStep);
+  if (full_rows_ != 0) {
+    PushState(State::ROWCLEAR);
   }
 }
 
 
-void Game::RowClearStep(double dt) {
+template <typename BoardT>
+void BasicGame<BoardT>::RowClearStep() {
   state_ = State::ROWCLEAR;
 
   if (paused_) {
-    states_.push_back(&Game::PausedStep);
+    PushState(State::PAUSED);
   }
 
-  time_ += dt;
+  timer_ += 1;
 
-  if (time_ < row_clear_time_) { return; }
+  if (timer_ < config_.row_clear_ticks) { return; }
 
   ClearFullRows();
   CheckLevel();
-  time_ = 0.0;
-  states_.pop_back();
+  timer_ = 0;
+  PopState();
 }
 
 
-void Game::PausedStep(double dt) {
+template <typename BoardT>
+void BasicGame<BoardT>::PausedStep() {
   state_ = State::PAUSED;
 
   if (!paused_) {
-    states_.pop_back();
+    PopState();
   }
 }
 
 
-void Game::GameOverStep(double dt) {
+template <typename BoardT>
+void BasicGame<BoardT>::GameOverStep() {
   state_ = State::GAMEOVER;
 
   if (!game_over_) {
@@ -136,160 +202,376 @@ void Game::GameOverStep(double dt) {
 }
 
 
-void Game::MovePieceLeft() {
-  *current_piece += {0, -1};
-  if (!ValidPosition(*current_piece)) {
-    *current_piece += {0, 1};
+template <typename BoardT>
+void BasicGame<BoardT>::Apply(Input input) {
+  switch (input) {
+    case Input::LEFT:
+      MovePieceLeft();
+      break;
+    case Input::RIGHT:
+      MovePieceRight();
+      break;
+    case Input::ROTATE_CW:
+      RotatePiece();
+      break;
+    case Input::ROTATE_CCW:
+      RotatePieceCCW();
+      break;
+    case Input::SOFT_DROP:
+      MovePieceDown();
+      break;
+    case Input::HARD_DROP:
+      HardDrop();
+      break;
   }
 }
 
 
-void Game::MovePieceRight() {
-  *current_piece += {0, 1};
-  if (!ValidPosition(*current_piece)) {
-    *current_piece += {0, -1};
+template <typename BoardT>
+void BasicGame<BoardT>::MovePieceLeft() {
+  current_piece += {0, -1};
+  if (!ValidPosition(current_piece)) {
+    current_piece += {0, 1};
+    return;
   }
+
+  Emit(EventType::MOVE);
 }
 
 
-void Game::HardDrop() {
-  while (true) {
-    *current_piece += {1, 0};
+template <typename BoardT>
+void BasicGame<BoardT>::MovePieceRight() {
+  current_piece += {0, 1};
+  if (!ValidPosition(current_piece)) {
+    current_piece += {0, -1};
+    return;
+  }
 
-    if (!ValidPosition(*current_piece)) {
-      *current_piece += {-1, 0};
-      break;
-    }
+  Emit(EventType::MOVE);
+}
+
+
+template <typename BoardT>
+void BasicGame<BoardT>::MovePieceDown() {
+  current_piece += {1, 0};
+  if (!ValidPosition(current_piece)) {
+    current_piece += {-1, 0};
+    return;
   }
 
-  time_ = pause_time_;
+  Emit(EventType::MOVE);
 }
 
 
-void Game::RotatePiece() {
-  // Try basic rotation
-  current_piece->RotateCW();
+template <typename BoardT>
+void BasicGame<BoardT>::HardDrop() {
+  const auto distance = DropDistance(current_piece);
+  current_piece += {distance, 0};
+  timer_ = DropTicks();
 
-  if (!ValidPosition(*current_piece)) {
-    current_piece->RotateCCW();
-  } else { return; }
+  if (distance > 0) {
+    Emit(EventType::MOVE);
+  }
+}
 
 
-  // Try wallkicks
-  const auto type = current_piece->type;
-  const auto rotation = current_piece->rotation;
-  std::vector<std::pair<int, int>> kicks;
-  if (type == PieceType::I) {
-    kicks = I_kicks_[rotation];
-  } else {
-    kicks = JLTSZ_kicks_[rotation];
+template <typename BoardT>
+void BasicGame<BoardT>::RotatePiece() {
+  if (TryRotate(current_piece, (current_piece.rotation+1) % 4)) {
+    Emit(EventType::ROTATE);
   }
+}
 
-  for (const auto& kick : kicks) {
-    current_piece->RotateCW();
-    *current_piece += {kick.first, kick.second};
 
-    if (!ValidPosition(*current_piece)) {
-      *current_piece += {-kick.first, -kick.second};
-      current_piece->RotateCCW();
-    } else { return; }
+template <typename BoardT>
+void BasicGame<BoardT>::RotatePieceCCW() {
+  if (TryRotate(current_piece, (current_piece.rotation+3) % 4)) {
+    Emit(EventType::ROTATE);
   }
 }
 
 
-Game::State Game::state() const {
+template <typename BoardT>
+bool BasicGame<BoardT>::TryRotate(Piece& piece, int to) const {
+  const auto from = piece.rotation;
+  const auto type = static_cast<int>(piece.type);
+
+  // Try basic rotation
+  piece.Rotate(to);
+  if (ValidPosition(piece)) { return true; }
+
+  // Try wallkicks
+  for (const auto& kick : wall_kicks[type][from][to]) {
+    piece += {kick.row, kick.col};
+
+    if (ValidPosition(piece)) { return true; }
+
+    piece += {-kick.row, -kick.col};
+  }
+
+  piece.Rotate(from);
+  return false;
+}
+
+
+template <typename BoardT>
+GameState BasicGame<BoardT>::state() const {
   return state_;
 }
 
 
-void Game::Restart() {
+template <typename BoardT>
+bool BasicGame<BoardT>::game_over() const {
+  return game_over_;
+}
+
+
+template <typename BoardT>
+void BasicGame<BoardT>::Restart() {
   game_over_ = false;
-  time_ = 0.0;
+  timer_ = 0;
   level_progression_ = 0;
   level_ = 1;
   score_ = 0;
+  pieces_ = 0;
+  lines_ = 0;
   paused_ = false;
-  pause_time_ = 1.0;
-  current_piece = GetRandomPiece();
-  next_piece = GetRandomPiece();
+  quick_drop_ = false;
+  gravity_ticks_ = config_.gravity_ticks;
+  queue_.Clear();
+  for (int i = 0; i < config_.preview; ++i) {
+    queue_.Push(randomizer_.Next());
+  }
+  SpawnNext();
 
   board.Clear();
+  board_hash_ = 0;
+  full_rows_ = 0;
+  surface_.fill(board.rows);
+  num_garbage_ = 0;
 
-  states_.clear();
-  states_.push_back(&Game::PlayingStep);
+  num_states_ = 0;
+  PushState(State::PLAYING);
 }
 
 
-void Game::TogglePause() {
-  paused_ = !paused_;
+template <typename BoardT>
+auto BasicGame<BoardT>::Snapshot() const -> GameSnapshot {
+  GameSnapshot s;
+  s.board = board;
+  s.current_piece = current_piece;
+  s.queue = queue_;
+  s.randomizer = randomizer_;
+  s.tick = tick_;
+  s.level = level_;
+  s.score = score_;
+  s.pieces = pieces_;
+  s.lines = lines_;
+  s.board_hash = board_hash_;
+  s.full_rows = full_rows_;
+  s.surface = surface_;
+  s.step_remainder = step_remainder_;
+  s.timer = timer_;
+  s.gravity_ticks = gravity_ticks_;
+  s.quick_drop = quick_drop_;
+  s.game_over = game_over_;
+  s.paused = paused_;
+  s.level_progression = level_progression_;
+  s.state = state_;
+
+  s.num_states = num_states_;
+  s.states = states_;
+
+  s.num_garbage = num_garbage_;
+  s.garbage = garbage_;
+
+  return s;
 }
 
 
-Points Game::GetDestination() const {
-  Points destination = *current_piece;
+template <typename BoardT>
+void BasicGame<BoardT>::Restore(const GameSnapshot& s) {
+  board = s.board;
+  current_piece = s.current_piece;
+  queue_ = s.queue;
+  randomizer_ = s.randomizer;
+  tick_ = s.tick;
+  level_ = s.level;
+  score_ = s.score;
+  pieces_ = s.pieces;
+  lines_ = s.lines;
+  board_hash_ = s.board_hash;
+  full_rows_ = s.full_rows;
+  surface_ = s.surface;
+  step_remainder_ = s.step_remainder;
+  timer_ = s.timer;
+  gravity_ticks_ = s.gravity_ticks;
+  quick_drop_ = s.quick_drop;
+  game_over_ = s.game_over;
+  paused_ = s.paused;
+  level_progression_ = s.level_progression;
+  state_ = s.state;
+
+  num_states_ = s.num_states;
+  states_ = s.states;
+
+  num_garbage_ = s.num_garbage;
+  garbage_ = s.garbage;
+}
 
-  while (ValidPosition(destination)) {
-    destination += {1, 0};
-  }
 
-  destination += {-1, 0};
+template <typename BoardT>
+void BasicGame<BoardT>::TogglePause() {
+  paused_ = !paused_;
+}
 
-  return destination;
+
+template <typename BoardT>
+void BasicGame<BoardT>::SetEventStream(EventStream* events) {
+  events_ = events;
 }
 
 
+template <typename BoardT>
+void BasicGame<BoardT>::QueueGarbage(int rows, int hole) {
+  if (rows <= 0 || hole < 0 || hole >= Board::cols) { return; }
 
-void Game::LockPieceAndSpawnNew() {
-  if (!ValidPosition(*current_piece)) {
-    game_over_ = true;
+  if (num_garbage_ == max_garbage) {
+    auto& last = garbage_[num_garbage_-1];
+    last.rows = std::min(last.rows + rows, Board::rows);
     return;
   }
 
-  for (const auto& p : *current_piece) {
-    board.matrix[p.row][p.col] = 1;
+  garbage_[num_garbage_++] = {
+    static_cast<uint8_t>(std::min(rows, Board::rows)),
+    static_cast<int8_t>(hole)};
+}
+
+
+template <typename BoardT>
+int BasicGame<BoardT>::CancelGarbage(int rows) {
+  int i = 0;
+  for (; i < num_garbage_ && rows > 0; ++i) {
+    const int cancelled = std::min<int>(rows, garbage_[i].rows);
+    garbage_[i].rows -= cancelled;
+    rows -= cancelled;
+    if (garbage_[i].rows > 0) { break; }
   }
 
-  current_piece = std::move(next_piece);
-  next_piece = GetRandomPiece();
+  // Drop the entries that were cancelled completely
+  std::copy(garbage_.begin() + i, garbage_.begin() + num_garbage_,
+            garbage_.begin());
+  num_garbage_ -= i;
+
+  return rows;
 }
 
 
-bool Game::RowIsFull(int row) const {
-  for (int j = 0; j < board.cols; ++j) {
-    if (board.matrix[row][j] == 0) {
-      return false;
-    }
+template <typename BoardT>
+int BasicGame<BoardT>::pending_garbage() const {
+  int rows = 0;
+  for (int i = 0; i < num_garbage_; ++i) {
+    rows += garbage_[i].rows;
   }
+  return rows;
+}
 
-  return true;
+
+template <typename BoardT>
+Points BasicGame<BoardT>::GetDestination() const {
+  Piece destination = current_piece;
+  destination += {DropDistance(destination), 0};
+  return destination.cells();
+}
+
+
+template <typename BoardT>
+int BasicGame<BoardT>::DropDistance(const Piece& piece) const {
+  const auto& mask = piece.mask();
+  const auto row = piece.origin.row;
+  const auto col = piece.origin.col;
+
+  // If every column of the piece is above that column's surface, the piece
+  // lands on the first surface it meets
+  int distance = board.rows;
+  bool above_surface = true;
+  for (int c = mask.left; c <= mask.right; ++c) {
+    const int lowest = row + mask.col_bottom[c];
+    const int surface = surface_[col+c];
+    above_surface = above_surface && lowest < surface;
+    distance = std::min(distance, surface - 1 - lowest);
+  }
+
+  if (above_surface) { return distance; }
+
+  // Otherwise the piece is tucked under an overhang, so step down
+  Piece p = piece;
+  distance = 0;
+  while (true) {
+    p += {1, 0};
+    if (!ValidPosition(p)) { return distance; }
+    distance += 1;
+  }
 }
 
 
-void Game::ClearRow(int row) {
-  if (row >= board.rows || row < 0) { return; }
 
-  for (int i = row; i >= 0; --i) {
-    for (int j = 0; j < board.cols; ++j) {
-      board.matrix[i+1][j] = board.matrix[i][j];
+template <typename BoardT>
+void BasicGame<BoardT>::LockPieceAndSpawnNew() {
+  if (!ValidPosition(current_piece)) {
+    TopOut();
+    return;
+  }
+
+  for (const auto& p : current_piece.cells()) {
+    board.Fill(p.row, p.col);
+    board_hash_ ^= zobrist_keys<BoardT>.cells[p.row][p.col];
+    surface_[p.col] = std::min<int8_t>(surface_[p.col], p.row);
+  }
+
+  // Only the rows the piece touched can have become full
+  for (const auto& p : current_piece.cells()) {
+    if (board.RowIsFull(p.row)) {
+      full_rows_ |= RowMask{1} << p.row;
     }
   }
+  pieces_ += 1;
+  Emit(EventType::LOCK);
 
-  for (int j = 0; j < board.cols; ++j) {
-    board.matrix[0][j] = 0;
+  // Garbage waits while rows are being cleared
+  if (full_rows_ == 0 && num_garbage_ > 0) {
+    RaiseGarbage();
   }
+
+  SpawnNext();
 }
 
 
-void Game::ClearFullRows() {
-  RowIndices cleared_rows;
-  for (int i = 0; i < board.rows; ++i) {
-    if (RowIsFull(i)) {
-      cleared_rows.push_back(i);
-      ClearRow(i-1);
-    }
+template <typename BoardT>
+void BasicGame<BoardT>::ClearFullRows() {
+  const int cleared_rows = std::popcount(full_rows_);
+
+  // Compact the board in one pass from the lowest full row upwards, moving
+  // every surviving row straight to its final position
+  int dest = std::bit_width(full_rows_) - 1;
+  for (int row = dest; row >= 0; --row) {
+    if (full_rows_ >> row & 1) { continue; }
+
+    const auto changed = board.matrix[dest] ^ board.matrix[row];
+    board_hash_ ^= ZobristRow<BoardT>(dest, changed);
+    board.matrix[dest] = board.matrix[row];
+    dest -= 1;
   }
 
-  switch (cleared_rows.size()) {
+  for (; dest >= 0; --dest) {
+    board_hash_ ^= ZobristRow<BoardT>(dest, board.matrix[dest]);
+    board.matrix[dest] = 0;
+  }
+
+  full_rows_ = 0;
+  UpdateSurface();
+
+  switch (cleared_rows) {
     case 1:
       score_ += 100*level_;
       break;
@@ -304,22 +586,30 @@ void Game::ClearFullRows() {
       break;
   }
 
-  level_progression_ += cleared_rows.size();
+  level_progression_ += cleared_rows;
+  lines_ += cleared_rows;
+  Emit(EventType::CLEAR, cleared_rows);
 }
 
 
-bool Game::ValidPosition(const Points& points) const {
-  for (const auto& p : points) {
-    if (p.row < 0 ||
-        p.row > board.rows-1 ||
-        p.col < 0 ||
-        p.col > board.cols-1) {
-      return false;
-    }
+template <typename BoardT>
+bool BasicGame<BoardT>::ValidPosition(const Piece& piece) const {
+  const auto& mask = piece.mask();
+  const auto row = piece.origin.row;
+  const auto col = piece.origin.col;
+
+  if (row+mask.top < 0 ||
+      row+mask.bottom > board.rows-1 ||
+      col+mask.left < 0 ||
+      col+mask.right > board.cols-1) {
+    return false;
   }
 
-  for (const auto& p : points) {
-    if (board.matrix[p.row][p.col] != 0) {
+  for (int i = mask.top; i <= mask.bottom; ++i) {
+    const auto bits = static_cast<typename Board::Row>(mask.rows[i]);
+    const typename Board::Row cells =
+      col >= 0 ? bits << col : bits >> -col;
+    if (board.matrix[row+i] & cells) {
       return false;
     }
   }
@@ -328,51 +618,128 @@ bool Game::ValidPosition(const Points& points) const {
 }
 
 
-void Game::CheckGameOver() {
+template <typename BoardT>
+void BasicGame<BoardT>::CheckGameOver() {
   auto InRowZero = [this] (Point p) { return p.row == 0; };
   auto IntersectExistingPiece = [this] (Point p) {
-    return board.matrix[p.row][p.col] != 0;
+    return board.Filled(p.row, p.col);
   };
 
-  if (std::ranges::any_of(*current_piece, InRowZero) &&
-      std::ranges::any_of(*current_piece, IntersectExistingPiece)) {
+  const auto cells = current_piece.cells();
+  if (std::ranges::any_of(cells, InRowZero) &&
+      std::ranges::any_of(cells, IntersectExistingPiece)) {
+    TopOut();
+  }
+}
+
+
+// Shift the board up and fill the bottom with the pending garbage. Filled
+// rows pushed off the top end the game.
+template <typename BoardT>
+void BasicGame<BoardT>::RaiseGarbage() {
+  auto& rows = board.matrix;
+
+  for (int i = 0; i < num_garbage_; ++i) {
+    const int n = garbage_[i].rows;
+    const auto hole = typename Board::Row{1} << garbage_[i].hole;
+    const auto line = static_cast<typename Board::Row>(Board::full_row & ~hole);
+
+    if (std::any_of(rows, rows + n, [] (auto row) { return row != 0; })) {
+      TopOut();
+    }
+
+    std::copy(rows + n, rows + Board::rows, rows);
+    std::fill(rows + Board::rows - n, rows + Board::rows, line);
+    Emit(EventType::GARBAGE, n);
+  }
+  num_garbage_ = 0;
+
+  // Every row moved, so rebuild the hash and the surface
+  board_hash_ = 0;
+  for (int row = 0; row < Board::rows; ++row) {
+    board_hash_ ^= ZobristRow<BoardT>(row, rows[row]);
+  }
+  UpdateSurface();
+}
+
+
+template <typename BoardT>
+void BasicGame<BoardT>::TopOut() {
+  if (!game_over_) {
     game_over_ = true;
+    Emit(EventType::TOP_OUT);
   }
 }
 
 
-void Game::CheckLevel() {
+// Recompute the surface of every column from the board
+template <typename BoardT>
+void BasicGame<BoardT>::UpdateSurface() {
+  surface_.fill(board.rows);
+
+  typename Board::Row seen = 0;
+  for (int row = 0; row < board.rows && seen != Board::full_row; ++row) {
+    typename Board::Row cells = board.matrix[row] & ~seen;
+    for (; cells; cells &= cells - 1) {
+      surface_[std::countr_zero(cells)] = row;
+    }
+    seen |= board.matrix[row];
+  }
+}
+
+
+template <typename BoardT>
+void BasicGame<BoardT>::CheckLevel() {
   if (level_progression_ >= 10) {
     level_progression_ = 0;
-    pause_time_ *= 0.9;
     level_ += 1;
+
+    // Gravity speeds up by 10% per level. Repeated multiplication keeps the
+    // rounding identical on every platform, unlike std::pow.
+    double speed = 1.0;
+    for (uint64_t i = 1; i < level_; ++i) {
+      speed *= 0.9;
+    }
+    gravity_ticks_ = std::max(1L, std::lround(config_.gravity_ticks*speed));
+    Emit(EventType::LEVEL, level_);
   }
 }
 
 
-Game::Piece_ptr Game::GetRandomPiece() {
-  std::uniform_int_distribution<int> dist{0,6};
-  auto n = dist(rng_);
+template <typename BoardT>
+int BasicGame<BoardT>::DropTicks() const {
+  return quick_drop_ ? config_.quick_drop_ticks : gravity_ticks_;
+}
 
-  switch (n) {
-    case 0:
-      return std::make_unique<IPiece>();
-    case 1:
-      return std::make_unique<JPiece>();
-    case 2:
-      return std::make_unique<LPiece>();
-    case 3:
-      return std::make_unique<OPiece>();
-    case 4:
-      return std::make_unique<SPiece>();
-    case 5:
-      return std::make_unique<TPiece>();
-    case 6:
-      return std::make_unique<ZPiece>();
-  }
 
-  return std::make_unique<LPiece>();
+// Pop the next piece off the queue and refill it from the randomizer
+template <typename BoardT>
+void BasicGame<BoardT>::SpawnNext() {
+  const auto type = queue_.Pop();
+  queue_.Push(randomizer_.Next());
+  current_piece = Piece::Spawn(type, Board::cols);
+  Emit(EventType::SPAWN);
+}
+
+
+template <typename BoardT>
+void BasicGame<BoardT>::Emit(EventType type, uint16_t value) const {
+  if (!events_) { return; }
+
+  events_->Push({
+    tick_,
+    type,
+    current_piece.type,
+    current_piece.rotation,
+    static_cast<int8_t>(current_piece.origin.row),
+    static_cast<int8_t>(current_piece.origin.col),
+    value});
 }
 
 
+template class BasicGame<Board>;
+template class BasicGame<TallBoard>;
+template class BasicGame<WideBoard>;
+
+
 } // namespace Tetris
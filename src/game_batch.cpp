@@ -0,0 +1,123 @@
+#include "game_batch.hpp"
+
+#include <cstring>
+
+#include "observation.hpp"
+
+
+namespace Tetris {
+
+
+// Every action but NOOP is the Input one below it
+static_assert(static_cast<int>(Action::LEFT) ==
+              static_cast<int>(Input::LEFT) + 1);
+static_assert(static_cast<int>(Action::HARD_DROP) ==
+              static_cast<int>(Input::HARD_DROP) + 1);
+
+
+template <typename BoardT>
+BasicGameBatch<BoardT>::BasicGameBatch(int size, const GameConfig& config)
+    : config_{config} {
+  games_.reserve(size);
+  for (int k = 0; k < size; ++k) {
+    auto game_config = config_;
+    game_config.seed += k;
+    games_.emplace_back(game_config);
+  }
+
+  obs_.board.resize(size*Board::rows);
+  obs_.piece.resize(size);
+  obs_.rotation.resize(size);
+  obs_.row.resize(size);
+  obs_.col.resize(size);
+  obs_.queue.resize(size*PieceQueue::capacity);
+  obs_.reward.resize(size);
+  obs_.done.resize(size);
+
+  for (int k = 0; k < size; ++k) {
+    Observe(k);
+  }
+}
+
+
+template <typename BoardT>
+void BasicGameBatch<BoardT>::Step(std::span<const Action> actions) {
+  const int n = size();
+  for (int k = 0; k < n; ++k) {
+    auto& game = games_[k];
+    const auto score = game.score();
+
+    if (actions[k] != Action::NOOP) {
+      game.Apply(static_cast<Input>(static_cast<int>(actions[k]) - 1));
+    }
+    game.Tick();
+
+    obs_.reward[k] = static_cast<int32_t>(game.score() - score);
+    obs_.done[k] = game.game_over();
+    if (obs_.done[k]) {
+      game.Restart();
+    }
+
+    Observe(k);
+  }
+}
+
+
+template <typename BoardT>
+void BasicGameBatch<BoardT>::Reset() {
+  for (int k = 0; k < size(); ++k) {
+    auto game_config = config_;
+    game_config.seed += k;
+    games_[k] = Game{game_config};
+
+    obs_.reward[k] = 0;
+    obs_.done[k] = 0;
+    Observe(k);
+  }
+}
+
+
+template <typename BoardT>
+int BasicGameBatch<BoardT>::size() const {
+  return static_cast<int>(games_.size());
+}
+
+
+template <typename BoardT>
+auto BasicGameBatch<BoardT>::observations() const -> const Observations& {
+  return obs_;
+}
+
+
+template <typename BoardT>
+auto BasicGameBatch<BoardT>::game(int k) const -> const Game& {
+  return games_[k];
+}
+
+
+template <typename BoardT>
+void BasicGameBatch<BoardT>::Observe(int k) {
+  const auto& game = games_[k];
+  const auto& piece = game.current_piece;
+
+  std::memcpy(&obs_.board[k*Board::rows], game.board.matrix,
+              sizeof(game.board.matrix));
+  obs_.piece[k] = static_cast<uint8_t>(piece.type);
+  obs_.rotation[k] = piece.rotation;
+  obs_.row[k] = static_cast<int8_t>(piece.origin.row);
+  obs_.col[k] = static_cast<int8_t>(piece.origin.col);
+
+  const auto& queue = game.queue();
+  uint8_t* types = &obs_.queue[k*PieceQueue::capacity];
+  for (int i = 0; i < PieceQueue::capacity; ++i) {
+    types[i] = i < queue.size() ? static_cast<uint8_t>(queue[i]) : no_piece;
+  }
+}
+
+
+template class BasicGameBatch<Board>;
+template class BasicGameBatch<TallBoard>;
+template class BasicGameBatch<WideBoard>;
+
+
+} // namespace Tetris
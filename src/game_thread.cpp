@@ -0,0 +1,76 @@
+#include "game_thread.hpp"
+
+#include <chrono>
+
+
+namespace Tetris {
+
+
+double GameThread::Now() {
+  const std::chrono::duration<double> time =
+    std::chrono::steady_clock::now().time_since_epoch();
+  return time.count();
+}
+
+
+GameThread::GameThread(const Game& game)
+    : game_{game}
+    , engine_{&game_, Now()}
+    , published_{game.Snapshot()}
+    , thread_{&GameThread::Run, this} {
+}
+
+
+GameThread::~GameThread() {
+  stop_.store(true, std::memory_order_relaxed);
+  thread_.join();
+}
+
+
+bool GameThread::Push(const Command& command) {
+  return commands_.Push(command);
+}
+
+
+auto GameThread::Latest() const -> Game::GameSnapshot {
+  std::lock_guard lock{mutex_};
+  return published_;
+}
+
+
+void GameThread::Run() {
+  const std::chrono::duration<double> tick{1.0 / game_.config().tick_rate};
+
+  while (!stop_.load(std::memory_order_relaxed)) {
+    Command command;
+    while (commands_.Pop(command)) {
+      if (command.type == CommandType::KEY) {
+        engine_.Push(command.key);
+        continue;
+      }
+
+      // Catch up to the command first, so it lands between the right keys
+      engine_.AdvanceTo(command.key.time);
+      if (command.type == CommandType::RESTART) {
+        game_.Restart();
+      } else {
+        game_.TogglePause();
+      }
+    }
+
+    engine_.AdvanceTo(Now());
+    Publish();
+
+    std::this_thread::sleep_for(tick);
+  }
+}
+
+
+void GameThread::Publish() {
+  const auto snapshot = game_.Snapshot();
+  std::lock_guard lock{mutex_};
+  published_ = snapshot;
+}
+
+
+} // namespace Tetris
@@ -1,114 +1,86 @@
 #include "input.hpp"
 
-#include "game.hpp"
-#include "render.hpp"
-
 
 namespace Tetris {
 
 
-Controller::Controller(Game* game) : game_{game} {}
-
+namespace {
 
-bool Controller::HandleInput() {
-  SDL_Event e;
 
-  auto pending = SDL_PollEvent(&e);
-  while (pending) {
-    if (e.type == SDL_QUIT) {
+// Find the game input a key controls. Returns false if it controls none.
+bool KeyInput(SDL_Keycode key, Input& input) {
+  switch (key) {
+    case SDLK_LEFT:
+      input = Input::LEFT;
       return true;
-    }
-
-    switch (game_->state()) {
-      case Game::State::PLAYING:
-        Playing(e);
-        break;
-      case Game::State::PAUSED:
-        Paused(e);
-        break;
-      case Game::State::GAMEOVER:
-        Paused(e);
-        break;
-      case Game::State::ROWCLEAR:
-        RowClear(e);
-        break;
-    }
-    pending = SDL_PollEvent(&e);
+    case SDLK_RIGHT:
+      input = Input::RIGHT;
+      return true;
+    case SDLK_DOWN:
+      input = Input::SOFT_DROP;
+      return true;
+    case SDLK_UP:
+      input = Input::ROTATE_CW;
+      return true;
+    case SDLK_SPACE:
+      input = Input::HARD_DROP;
+      return true;
+    default:
+      return false;
   }
-
-  return false;
 }
 
 
-void Controller::Playing(const SDL_Event& e) {
-  if (e.type == SDL_KEYDOWN) {
-    switch (e.key.keysym.sym) {
-      case SDLK_LEFT:
-        game_->MovePieceLeft();
-        break;
-      case SDLK_RIGHT:
-        game_->MovePieceRight();
-        break;
-      case SDLK_DOWN:
-        game_->QuickDrop(true);
-        break;
-      case SDLK_UP:
-        game_->RotatePiece();
-        break;
-      case SDLK_SPACE:
-        game_->HardDrop();
-        break;
-      case SDLK_r:
-        game_->Restart();
-        break;
-      case SDLK_ESCAPE:
-        game_->TogglePause();
-        break;
-    }
-  }
+} // namespace
 
-  if (e.type == SDL_KEYUP) {
-    switch (e.key.keysym.sym) {
-      case SDLK_DOWN:
-        game_->QuickDrop(false);
-        break;
-    }
-  }
-}
 
+Controller::Controller(GameThread* game) : game_{game} {}
+
+
+bool Controller::HandleInput(Uint32 deadline) {
+  SDL_Event e;
+
+  while (true) {
+    // Sleep until an event arrives, so it is stamped and sent on right away
+    // rather than at the next frame. A timeout of 0 only polls.
+    const auto now = SDL_GetTicks();
+    const int timeout = SDL_TICKS_PASSED(now, deadline) ? 0 : deadline - now;
+    if (!SDL_WaitEventTimeout(&e, timeout)) { return false; }
 
-void Controller::Paused(const SDL_Event& e) {
-  if (e.type == SDL_KEYDOWN) {
-    switch (e.key.keysym.sym) {
-      case SDLK_r:
-        game_->Restart();
-        break;
-      case SDLK_ESCAPE:
-        game_->TogglePause();
-        break;
+    if (e.type == SDL_QUIT) {
+      return true;
     }
+    Forward(e);
   }
 }
 
 
-void Controller::RowClear(const SDL_Event& e) {
-  if (e.type == SDL_KEYDOWN) {
-    switch (e.key.keysym.sym) {
-      case SDLK_r:
-        game_->Restart();
-        break;
-      case SDLK_ESCAPE:
-        game_->TogglePause();
-        break;
-    }
+void Controller::Forward(const SDL_Event& e) {
+  // Held keys are repeated by the game's InputEngine, not the OS
+  const bool key = e.type == SDL_KEYDOWN || e.type == SDL_KEYUP;
+  if (!key || e.key.repeat) { return; }
+
+  Command command;
+  command.key.time = GameThread::Now();
+
+  if (KeyInput(e.key.keysym.sym, command.key.input)) {
+    command.type = CommandType::KEY;
+    command.key.down = e.type == SDL_KEYDOWN;
+    game_->Push(command);
+    return;
   }
 
-  if (e.type == SDL_KEYUP) {
-    switch (e.key.keysym.sym) {
-      case SDLK_DOWN:
-        game_->QuickDrop(false);
-        break;
-    }
+  if (e.type != SDL_KEYDOWN) { return; }
+
+  switch (e.key.keysym.sym) {
+    case SDLK_r:
+      command.type = CommandType::RESTART;
+      game_->Push(command);
+      break;
+    case SDLK_ESCAPE:
+      command.type = CommandType::PAUSE;
+      game_->Push(command);
+      break;
   }
 }
 
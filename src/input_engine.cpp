@@ -0,0 +1,137 @@
+#include "input_engine.hpp"
+
+#include <algorithm>
+
+
+namespace Tetris {
+
+
+InputEngine::InputEngine(Game* game, double time)
+    : game_{game}, start_{time} {}
+
+
+void InputEngine::Push(const KeyEvent& e) {
+  pending_.push_back(e);
+}
+
+
+void InputEngine::AdvanceTo(double time) {
+  const auto target = TickAt(time);
+
+  while (true) {
+    // Events from before the current tick, for example pushed late, are
+    // applied as soon as possible
+    while (!pending_.empty() && TickAt(pending_.front().time) <= ticks_) {
+      Apply(pending_.front());
+      pending_.pop_front();
+    }
+
+    if (ticks_ >= target) { break; }
+
+    AutoShift();
+    game_->Tick();
+    ticks_ += 1;
+    shift_ticks_ += 1;
+  }
+}
+
+
+uint64_t InputEngine::TickAt(double time) const {
+  const auto ticks = (time - start_)*game_->config().tick_rate;
+  return static_cast<uint64_t>(std::max(0.0, ticks));
+}
+
+
+void InputEngine::Apply(const KeyEvent& e) {
+  const auto i = static_cast<int>(e.input);
+  if (held_[i] == e.down) { return; }
+
+  held_[i] = e.down;
+  if (e.down) {
+    Press(e.input);
+  } else {
+    Release(e.input);
+  }
+}
+
+
+void InputEngine::Press(Input input) {
+  switch (input) {
+    case Input::LEFT:
+    case Input::RIGHT:
+      // The newest direction wins while both are held
+      shift_ = input == Input::LEFT ? -1 : 1;
+      shift_ticks_ = 0;
+      if (Playing()) {
+        Shift();
+      }
+      break;
+    case Input::SOFT_DROP:
+      if (Playing()) {
+        game_->QuickDrop(true);
+      }
+      break;
+    default:
+      if (Playing()) {
+        game_->Apply(input);
+      }
+      break;
+  }
+}
+
+
+void InputEngine::Release(Input input) {
+  switch (input) {
+    case Input::LEFT:
+    case Input::RIGHT: {
+      const int direction = input == Input::LEFT ? -1 : 1;
+      if (shift_ != direction) { break; }
+
+      // Fall back to the other direction if it is still held, charging its
+      // delay from the start
+      const auto other = input == Input::LEFT ? Input::RIGHT : Input::LEFT;
+      shift_ = held_[static_cast<int>(other)] ? -direction : 0;
+      shift_ticks_ = 0;
+      break;
+    }
+    case Input::SOFT_DROP:
+      game_->QuickDrop(false);
+      break;
+    default:
+      break;
+  }
+}
+
+
+void InputEngine::AutoShift() {
+  if (shift_ == 0 || shift_ticks_ == 0 || !Playing()) { return; }
+
+  const auto& config = game_->config();
+  const int repeat = shift_ticks_ - config.das_ticks;
+  if (repeat < 0) { return; }
+
+  if (config.arr_ticks == 0) {
+    while (Shift()) {}
+  } else if (repeat % config.arr_ticks == 0) {
+    Shift();
+  }
+}
+
+
+bool InputEngine::Shift() {
+  const auto col = game_->current_piece.origin.col;
+  if (shift_ < 0) {
+    game_->MovePieceLeft();
+  } else {
+    game_->MovePieceRight();
+  }
+  return game_->current_piece.origin.col != col;
+}
+
+
+bool InputEngine::Playing() const {
+  return game_->state() == GameState::PLAYING;
+}
+
+
+} // namespace Tetris
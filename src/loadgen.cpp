@@ -0,0 +1,288 @@
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "game.hpp"
+#include "net.hpp"
+#include "protocol.hpp"
+
+
+// Load generator for tetris_server: opens many sessions and keeps one step
+// in flight on each, playing random actions, then reports the step rate and
+// latency percentiles. Responses are checked and applied to a copy of each
+// board, as a real client would.
+//
+// Usage: tetris_loadgen [--unix PATH | --port N] [--sessions S]
+//                       [--threads T] [--seconds D] [--ticks K]
+
+
+namespace {
+
+
+using Tetris::Board;
+using Tetris::Request;
+using Tetris::RequestKind;
+using Tetris::Response;
+using Tetris::RowUpdate;
+using Clock = std::chrono::steady_clock;
+
+
+struct Options {
+  Tetris::Endpoint endpoint;
+  unsigned sessions = 1000;
+  unsigned threads = std::thread::hardware_concurrency();
+  double seconds = 10;
+  uint16_t ticks = 1; // Game ticks per step
+};
+
+
+struct Client {
+  int fd;
+  uint64_t seed;
+  std::minstd_rand rng;
+  std::array<Board::Row, Board::rows> board{};
+
+  std::array<uint8_t, sizeof(Response) + Board::rows*sizeof(RowUpdate)> in;
+  size_t in_size = 0;
+  uint32_t sequence = 0;
+  RequestKind kind; // Of the request in flight
+  Clock::time_point sent;
+};
+
+
+struct Results {
+  uint64_t steps = 0;
+  uint64_t resets = 0;
+  uint64_t errors = 0; // Sessions closed on a failure
+  std::vector<uint32_t> latency; // Nanoseconds per step
+};
+
+
+bool ParseOptions(int argc, char** argv, Options& o) {
+  for (int i = 1; i < argc; ++i) {
+    const bool has_value = i+1 < argc;
+    if (!has_value) { return false; }
+
+    const char* value = argv[++i];
+    if (std::strcmp(argv[i-1], "--unix") == 0) {
+      o.endpoint.path = value;
+    } else if (std::strcmp(argv[i-1], "--port") == 0) {
+      o.endpoint.port = std::strtoul(value, nullptr, 10);
+    } else if (std::strcmp(argv[i-1], "--sessions") == 0) {
+      o.sessions = std::strtoul(value, nullptr, 10);
+    } else if (std::strcmp(argv[i-1], "--threads") == 0) {
+      o.threads = std::strtoul(value, nullptr, 10);
+    } else if (std::strcmp(argv[i-1], "--seconds") == 0) {
+      o.seconds = std::strtod(value, nullptr);
+    } else if (std::strcmp(argv[i-1], "--ticks") == 0) {
+      o.ticks = std::strtoul(value, nullptr, 10);
+    } else {
+      return false;
+    }
+  }
+
+  o.threads = std::clamp(o.threads, 1u, std::max(1u, o.sessions));
+  return true;
+}
+
+
+bool Send(Client& c, RequestKind kind, const Options& o) {
+  Request request{};
+  request.kind = kind;
+  request.sequence = ++c.sequence;
+  c.kind = kind;
+  if (kind == RequestKind::RESET) {
+    request.seed = c.seed;
+    c.board.fill(0);
+  } else {
+    request.action = static_cast<Tetris::Action>(c.rng() % 7);
+    request.ticks = o.ticks;
+  }
+
+  // With one request in flight the socket buffer always has room
+  c.sent = Clock::now();
+  return send(c.fd, &request, sizeof(request), MSG_NOSIGNAL) ==
+         static_cast<ssize_t>(sizeof(request));
+}
+
+
+// Read and apply a response, then send the next request. Returns false if
+// the session failed.
+bool Receive(Client& c, const Options& o, Results& results, bool more) {
+  const auto n = read(c.fd, c.in.data() + c.in_size,
+                      c.in.size() - c.in_size);
+  if (n == 0) { return false; }
+  if (n < 0) { return errno == EAGAIN || errno == EWOULDBLOCK; }
+  c.in_size += n;
+
+  if (c.in_size < sizeof(Response)) { return true; }
+  Response response;
+  std::memcpy(&response, c.in.data(), sizeof(response));
+
+  const auto size = sizeof(Response) + response.num_rows*sizeof(RowUpdate);
+  if (response.sequence != c.sequence || response.num_rows > Board::rows) {
+    return false;
+  }
+  if (c.in_size < size) { return true; }
+  if (c.in_size > size) { return false; } // Only one response is expected
+
+  const auto latency = Clock::now() - c.sent;
+  for (int i = 0; i < response.num_rows; ++i) {
+    RowUpdate update;
+    std::memcpy(&update, c.in.data() + sizeof(Response) + i*sizeof(update),
+                sizeof(update));
+    if (update.row >= Board::rows) { return false; }
+    c.board[update.row] = update.cells;
+  }
+  c.in_size = 0;
+
+  // A step counts even if it ended the game
+  if (c.kind == RequestKind::RESET) {
+    results.resets += c.sequence > 1; // Not the session's first game
+  } else {
+    results.steps += 1;
+    results.latency.push_back(static_cast<uint32_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(latency)
+        .count()));
+  }
+
+  if (!more) { return true; }
+  const auto kind = response.state == Tetris::GameState::GAMEOVER ?
+    RequestKind::RESET : RequestKind::STEP;
+  return Send(c, kind, o);
+}
+
+
+void Worker(const Options& o, unsigned first, unsigned count,
+            Results& results) {
+  const int epoll = epoll_create1(0);
+  if (epoll < 0) {
+    std::perror("epoll_create1");
+    return;
+  }
+
+  std::vector<Client> clients(count);
+  for (unsigned i = 0; i < count; ++i) {
+    auto& c = clients[i];
+    c.seed = first + i;
+    c.rng.seed(c.seed + 1);
+    c.fd = Tetris::Connect(o.endpoint);
+    if (c.fd < 0) {
+      results.errors += 1;
+      continue;
+    }
+
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.ptr = &c;
+    epoll_ctl(epoll, EPOLL_CTL_ADD, c.fd, &ev);
+  }
+
+  for (auto& c : clients) {
+    if (c.fd >= 0 && !Send(c, RequestKind::RESET, o)) {
+      results.errors += 1;
+      close(c.fd);
+      c.fd = -1;
+    }
+  }
+
+  results.latency.reserve(1 << 20);
+  const auto deadline =
+    Clock::now() + std::chrono::duration<double>(o.seconds);
+  std::array<epoll_event, 256> events;
+  while (true) {
+    const bool more = Clock::now() < deadline;
+    const int n = epoll_wait(epoll, events.data(), events.size(), 100);
+    if (n <= 0 && !more) { break; }
+
+    for (int i = 0; i < n; ++i) {
+      auto& c = *static_cast<Client*>(events[i].data.ptr);
+      if (!Receive(c, o, results, more)) {
+        results.errors += 1;
+        close(c.fd);
+        c.fd = -1;
+      }
+    }
+  }
+
+  for (auto& c : clients) {
+    if (c.fd >= 0) {
+      close(c.fd);
+    }
+  }
+  close(epoll);
+}
+
+
+double Percentile(std::vector<uint32_t>& v, double p) {
+  if (v.empty()) { return 0; }
+  const auto k = static_cast<size_t>(p*(v.size() - 1));
+  std::nth_element(v.begin(), v.begin() + k, v.end());
+  return v[k]/1000.0;
+}
+
+
+} // namespace
+
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!ParseOptions(argc, argv, options)) {
+    std::fprintf(stderr,
+        "Usage: %s [--unix PATH | --port N] [--sessions S] [--threads T] "
+        "[--seconds D] [--ticks K]\n", argv[0]);
+    return 1;
+  }
+
+  Tetris::RaiseFileLimit();
+
+  std::vector<Results> results(options.threads);
+  std::vector<std::thread> threads;
+
+  const auto start = Clock::now();
+  for (unsigned t = 0, first = 0; t < options.threads; ++t) {
+    const unsigned count = options.sessions/options.threads +
+                           (t < options.sessions%options.threads);
+    threads.emplace_back(
+        Worker, std::cref(options), first, count, std::ref(results[t]));
+    first += count;
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  const std::chrono::duration<double> elapsed = Clock::now() - start;
+
+  Results sum;
+  for (auto& r : results) {
+    sum.steps += r.steps;
+    sum.resets += r.resets;
+    sum.errors += r.errors;
+    sum.latency.insert(sum.latency.end(), r.latency.begin(), r.latency.end());
+  }
+
+  const double max = sum.latency.empty() ? 0 :
+    *std::max_element(sum.latency.begin(), sum.latency.end())/1000.0;
+
+  std::printf("sessions    %u (%llu failed)\n", options.sessions,
+              static_cast<unsigned long long>(sum.errors));
+  std::printf("steps       %llu (%llu games ended)\n",
+              static_cast<unsigned long long>(sum.steps),
+              static_cast<unsigned long long>(sum.resets));
+  std::printf("steps/s     %.0f\n", sum.steps/elapsed.count());
+  std::printf("latency us  p50 %.1f  p99 %.1f  p99.9 %.1f  max %.1f\n",
+              Percentile(sum.latency, 0.5), Percentile(sum.latency, 0.99),
+              Percentile(sum.latency, 0.999), max);
+
+  return sum.errors == 0 ? 0 : 1;
+}
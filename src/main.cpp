@@ -7,24 +7,32 @@
 #include "game.hpp"
 #include "render.hpp"
 #include "input.hpp"
+#include "game_thread.hpp"
 
 
 int main() {
 
+  // The game runs on its own thread. This thread renders a copy of it and
+  // passes input on between frames.
   Tetris::Game tetris;
   Tetris::Renderer renderer{tetris};
-  Tetris::Controller controller{&tetris};
+  Tetris::GameThread game_thread{tetris};
+  Tetris::Controller controller{&game_thread};
 
   // Game loop
-  auto time = SDL_GetTicks();
+  const Uint32 frame_time = 1000/60;
+  auto deadline = SDL_GetTicks();
   while (true) {
-    bool quit = controller.HandleInput();
-    if (quit) { break; }
+    // Skip frames that were missed rather than rushing to catch up
+    deadline += frame_time;
+    if (SDL_TICKS_PASSED(SDL_GetTicks(), deadline + frame_time)) {
+      deadline = SDL_GetTicks();
+    }
 
-    auto elapsed_time = (SDL_GetTicks()-time) / 1000.0;
-    time = SDL_GetTicks();
+    bool quit = controller.HandleInput(deadline);
+    if (quit) { break; }
 
-    tetris.Step(elapsed_time);
+    tetris.Restore(game_thread.Latest());
     renderer.Render();
   }
 
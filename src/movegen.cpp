@@ -0,0 +1,400 @@
+#include "movegen.hpp"
+
+#include <algorithm>
+#include <bit>
+
+
+namespace Tetris {
+
+
+namespace {
+
+
+// Several orientations of the I, S and Z pieces cover the same cells at a
+// different origin. For deduplication every orientation is mapped to the
+// lowest rotation with the same shape and the origin offset between them.
+struct Canonical {
+  int rotation;
+  Point offset;
+};
+
+
+constexpr auto MakeCanonical() {
+  std::array<std::array<Canonical, 4>, 7> canonical{};
+
+  for (int type = 0; type < 7; ++type) {
+    for (int rotation = 0; rotation < 4; ++rotation) {
+      const auto& m = shape_masks[type][rotation];
+      canonical[type][rotation] = {rotation, {0, 0}};
+
+      for (int other = 0; other < rotation; ++other) {
+        const auto& o = shape_masks[type][other];
+        bool same = m.bottom-m.top == o.bottom-o.top;
+        for (int i = 0; same && i <= m.bottom-m.top; ++i) {
+          same = (m.rows[m.top+i] >> m.left) == (o.rows[o.top+i] >> o.left);
+        }
+
+        if (same) {
+          canonical[type][rotation] = {
+            other, {m.top-o.top, m.left-o.left}};
+          break;
+        }
+      }
+    }
+  }
+
+  return canonical;
+}
+
+constexpr auto canonical = MakeCanonical();
+
+
+} // namespace
+
+
+template <typename BoardT>
+uint16_t BasicMoveGenerator<BoardT>::Encode(int rotation, int row, int col) {
+  return (rotation*num_rows + row+row_bias)*num_cols + col+col_bias;
+}
+
+
+// Precompute the rows each rotation fits at in each column, so the search
+// itself only does bit operations. This is the same test as
+// Game::ValidPosition, done for a whole column at once: the board is
+// transposed into one mask of filled rows per board column, and a piece
+// cell i rows below the origin collides wherever that mask shifted up by i
+// has a bit.
+template <typename BoardT>
+void BasicMoveGenerator<BoardT>::ComputeFits(
+    const Board& board, PieceType type) {
+  type_ = type;
+
+  // Everything below the board counts as filled
+  std::array<Column, Board::cols> filled;
+  filled.fill(~Column{0} << (Board::rows + row_bias));
+  for (int row = 0; row < board.rows; ++row) {
+    for (auto bits = board.matrix[row]; bits; bits &= bits - 1) {
+      filled[std::countr_zero(bits)] |= Column{1} << (row + row_bias);
+    }
+  }
+
+  constexpr Column all_rows = (Column{1} << num_rows) - 1;
+  for (int rotation = 0; rotation < 4; ++rotation) {
+    const auto& m = shape_masks[static_cast<int>(type)][rotation];
+    const auto& shape = piece_shapes[static_cast<int>(type)][rotation];
+
+    // No cell may be above the board
+    const Column rows = all_rows & (~Column{0} << (row_bias - m.top));
+
+    auto& fits = fits_[rotation];
+    fits.fill(0);
+    for (int col = -m.left; col+m.right < Board::cols; ++col) {
+      Column blocked = 0;
+      for (const auto& p : shape) {
+        blocked |= filled[col + p.col] >> p.row;
+      }
+      fits[col + col_bias] = rows & ~blocked;
+    }
+  }
+}
+
+
+template <typename BoardT>
+bool BasicMoveGenerator<BoardT>::Fits(int rotation, int row, int col) const {
+  if (row < -row_bias || row >= Board::rows ||
+      col < -col_bias || col >= Board::cols) {
+    return false;
+  }
+
+  return (fits_[rotation][col + col_bias] >> (row + row_bias)) & 1;
+}
+
+
+// Same rules as Game::TryRotate: the basic rotation, then each wall kick in
+// order.
+template <typename BoardT>
+bool BasicMoveGenerator<BoardT>::Rotate(Node& node, int to) const {
+  if (Fits(to, node.row, node.col)) {
+    node.rotation = to;
+    return true;
+  }
+
+  const auto& kicks = wall_kicks[static_cast<int>(type_)][node.rotation][to];
+  for (const auto& kick : kicks) {
+    if (Fits(to, node.row+kick.row, node.col+kick.col)) {
+      node = {static_cast<int8_t>(to),
+              static_cast<int8_t>(node.row+kick.row),
+              static_cast<int8_t>(node.col+kick.col)};
+      return true;
+    }
+  }
+
+  return false;
+}
+
+
+// Mark rows of a column as reached, queueing the column if any are new
+template <typename BoardT>
+void BasicMoveGenerator<BoardT>::Reach(int rotation, int col, Column rows) {
+  auto& reached = reached_[rotation][col + col_bias];
+  if ((rows & ~reached) == 0) { return; }
+
+  reached |= rows;
+  const int index = rotation*num_cols + col + col_bias;
+  if (!pending_[index]) {
+    pending_[index] = true;
+    stack_[stack_size_++] = static_cast<uint8_t>(index);
+  }
+}
+
+
+// Apply every input to the rows of a column reached since it was last
+// expanded, all at once
+template <typename BoardT>
+void BasicMoveGenerator<BoardT>::Expand(int rotation, int col) {
+  const int i = col + col_bias;
+  const auto& fits = fits_[rotation];
+
+  // Fall through every row that fits below a reached one, doubling the
+  // distance each step
+  Column open = fits[i];
+  Column rows = reached_[rotation][i];
+  for (int shift = 1; shift < num_rows; shift *= 2) {
+    rows |= (rows << shift) & open;
+    open &= open << shift;
+  }
+  reached_[rotation][i] = rows;
+
+  rows &= ~expanded_[rotation][i];
+  expanded_[rotation][i] |= rows;
+  if (!rows) { return; }
+
+  if (col-1 >= -col_bias) {
+    Reach(rotation, col-1, rows & fits[i-1]);
+  }
+  if (col+1 < Board::cols) {
+    Reach(rotation, col+1, rows & fits[i+1]);
+  }
+
+  // Rotations take the first of the basic position and the kicks that fits,
+  // so each option only gets the rows no earlier one took
+  for (const int to : {(rotation+1) % 4, (rotation+3) % 4}) {
+    const auto& kicks = wall_kicks[static_cast<int>(type_)][rotation][to];
+    Column left = rows;
+
+    for (int k = -1; left && k < static_cast<int>(kicks.size()); ++k) {
+      const Point kick = k < 0 ? Point{0, 0} : kicks[k];
+      const int target = col + kick.col;
+      if (target < -col_bias || target >= Board::cols) { continue; }
+
+      // Rows whose kicked position fits, in the coordinates of this column
+      const Column to_fits = fits_[to][target + col_bias];
+      const Column fit = kick.row >= 0 ?
+        to_fits >> kick.row : to_fits << -kick.row;
+      const Column moved = left & fit;
+      left &= ~fit;
+
+      if (moved) {
+        Reach(to, target, kick.row >= 0 ?
+            moved << kick.row : moved >> -kick.row);
+      }
+    }
+  }
+}
+
+
+template <typename BoardT>
+auto BasicMoveGenerator<BoardT>::Generate(const Game& game)
+    -> std::span<const Placement> {
+  const auto& start = game.current_piece;
+  ComputeFits(game.board, start.type);
+  root_ = {static_cast<int8_t>(start.rotation),
+           static_cast<int8_t>(start.origin.row),
+           static_cast<int8_t>(start.origin.col)};
+  if (!Fits(root_.rotation, root_.row, root_.col)) { return {}; }
+
+  for (int rotation = 0; rotation < 4; ++rotation) {
+    reached_[rotation].fill(0);
+    expanded_[rotation].fill(0);
+  }
+  pending_.reset();
+  stack_size_ = 0;
+
+  Reach(root_.rotation, root_.col, Column{1} << (root_.row + row_bias));
+  while (stack_size_ > 0) {
+    const int index = stack_[--stack_size_];
+    pending_[index] = false;
+    Expand(index / num_cols, index % num_cols - col_bias);
+  }
+
+  // Collect the rows where the piece cannot fall further. Every rotation is
+  // mapped onto the lowest one with the same cells, so placements covering
+  // the same cells are only recorded once.
+  for (auto& placed : placed_) {
+    placed.fill(0);
+  }
+
+  int count = 0;
+  for (int rotation = 0; rotation < 4; ++rotation) {
+    const auto& c = canonical[static_cast<int>(type_)][rotation];
+
+    for (int col = -col_bias; col < Board::cols; ++col) {
+      const auto i = col + col_bias;
+      const auto& fits = fits_[rotation][i];
+      const Column resting = reached_[rotation][i] & ~(fits >> 1);
+      if (!resting) { continue; }
+
+      auto& placed = placed_[c.rotation][i + c.offset.col];
+      const Column rows = c.offset.row >= 0 ?
+        resting << c.offset.row : resting >> -c.offset.row;
+
+      for (auto bits = rows & ~placed; bits; bits &= bits - 1) {
+        const int row = std::countr_zero(bits) - row_bias - c.offset.row;
+        placements_[count++] = {
+          {type_, static_cast<uint8_t>(rotation), {row, col}}};
+      }
+      placed |= rows;
+    }
+  }
+
+  return {placements_.data(), static_cast<size_t>(count)};
+}
+
+
+// Try the path bots usually take: rotate at the spawn position, shift
+// sideways, hard drop. Fails for placements that need a tuck or a spin.
+template <typename BoardT>
+bool BasicMoveGenerator<BoardT>::DirectPath(
+    const Node& target, Path& path) const {
+  const int turns = (target.rotation - root_.rotation + 4) % 4;
+
+  for (const auto input : {Input::ROTATE_CW, Input::ROTATE_CCW}) {
+    const int step = input == Input::ROTATE_CW ? 1 : 3;
+    const int count = turns == 2 ? 2 : turns == 0 ? 0 :
+      (step == 1) == (turns == 1) ? 1 : -1;
+    if (count < 0) { continue; }
+
+    Node node = root_;
+    path.size = 0;
+    bool ok = true;
+    for (int i = 0; ok && i < count; ++i) {
+      ok = Rotate(node, (node.rotation + step) % 4);
+      path.inputs[path.size++] = input;
+    }
+
+    const int dir = target.col < node.col ? -1 : 1;
+    while (ok && node.col != target.col) {
+      ok = Fits(node.rotation, node.row, node.col + dir);
+      node.col += dir;
+      path.inputs[path.size++] = dir < 0 ? Input::LEFT : Input::RIGHT;
+    }
+    if (!ok) { continue; }
+
+    const Column below =
+      fits_[node.rotation][node.col + col_bias] >> (node.row + row_bias + 1);
+    if (node.row + std::countr_one(below) == target.row) {
+      path.inputs[path.size++] = Input::HARD_DROP;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+
+// Breadth-first search over single inputs, for the placements DirectPath()
+// cannot reach.
+template <typename BoardT>
+bool BasicMoveGenerator<BoardT>::SearchPath(const Node& target, Path& path) {
+  visited_.reset();
+  int head = 0;
+  int tail = 0;
+
+  const auto root_state = Encode(root_.rotation, root_.row, root_.col);
+  const auto target_state = Encode(target.rotation, target.row, target.col);
+  visited_[root_state] = true;
+  parent_[root_state] = root_state;
+  depth_[root_state] = 0;
+  queue_[tail++] = root_;
+
+  while (head < tail && !visited_[target_state]) {
+    const Node node = queue_[head++];
+    const auto state = Encode(node.rotation, node.row, node.col);
+
+    // Leave room for the final hard drop in the path
+    if (depth_[state] >= max_path-1) { continue; }
+
+    auto Expand = [&] (const Node& next, Input input) {
+      const auto s = Encode(next.rotation, next.row, next.col);
+      if (visited_[s]) { return; }
+
+      visited_[s] = true;
+      parent_[s] = state;
+      input_[s] = input;
+      depth_[s] = depth_[state] + 1;
+      queue_[tail++] = next;
+    };
+
+    if (Fits(node.rotation, node.row, node.col-1)) {
+      Expand({node.rotation, node.row, int8_t(node.col-1)}, Input::LEFT);
+    }
+
+    if (Fits(node.rotation, node.row, node.col+1)) {
+      Expand({node.rotation, node.row, int8_t(node.col+1)}, Input::RIGHT);
+    }
+
+    if (Fits(node.rotation, node.row+1, node.col)) {
+      Expand({node.rotation, int8_t(node.row+1), node.col}, Input::SOFT_DROP);
+    }
+
+    Node cw = node;
+    if (Rotate(cw, (node.rotation+1) % 4)) {
+      Expand(cw, Input::ROTATE_CW);
+    }
+
+    Node ccw = node;
+    if (Rotate(ccw, (node.rotation+3) % 4)) {
+      Expand(ccw, Input::ROTATE_CCW);
+    }
+  }
+
+  if (!visited_[target_state]) { return false; }
+
+  // Walk back to the root, then reverse
+  path.size = 0;
+  for (auto s = target_state; parent_[s] != s; s = parent_[s]) {
+    path.inputs[path.size++] = input_[s];
+  }
+  std::reverse(path.inputs.begin(), path.inputs.begin() + path.size);
+
+  // The trailing soft drops end where a hard drop lands
+  while (path.size > 0 && path.inputs[path.size-1] == Input::SOFT_DROP) {
+    path.size -= 1;
+  }
+  path.inputs[path.size++] = Input::HARD_DROP;
+
+  return true;
+}
+
+
+template <typename BoardT>
+auto BasicMoveGenerator<BoardT>::GetPath(const Placement& placement)
+    -> Path {
+  const Node target{static_cast<int8_t>(placement.piece.rotation),
+                    static_cast<int8_t>(placement.piece.origin.row),
+                    static_cast<int8_t>(placement.piece.origin.col)};
+
+  Path path;
+  if (!DirectPath(target, path) && !SearchPath(target, path)) {
+    path.size = 0;
+  }
+  return path;
+}
+
+
+template class BasicMoveGenerator<Board>;
+template class BasicMoveGenerator<TallBoard>;
+template class BasicMoveGenerator<WideBoard>;
+
+
+} // namespace Tetris
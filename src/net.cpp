@@ -0,0 +1,130 @@
+#include "net.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+
+namespace Tetris {
+
+
+namespace {
+
+
+// Fill in the address of an endpoint. Returns its length, or 0 if the path
+// does not fit.
+socklen_t MakeAddress(const Endpoint& e, sockaddr_storage& storage) {
+  std::memset(&storage, 0, sizeof(storage));
+
+  if (!e.path.empty()) {
+    auto& addr = reinterpret_cast<sockaddr_un&>(storage);
+    if (e.path.size() >= sizeof(addr.sun_path)) { return 0; }
+
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, e.path.c_str(), e.path.size() + 1);
+    return sizeof(addr);
+  }
+
+  auto& addr = reinterpret_cast<sockaddr_in&>(storage);
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(e.port);
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  return sizeof(addr);
+}
+
+
+int Fail(const char* what, int fd = -1) {
+  std::perror(what);
+  if (fd >= 0) {
+    close(fd);
+  }
+  return -1;
+}
+
+
+} // namespace
+
+
+int Listen(const Endpoint& e) {
+  sockaddr_storage addr;
+  const auto length = MakeAddress(e, addr);
+  if (length == 0) {
+    std::fprintf(stderr, "Socket path too long: %s\n", e.path.c_str());
+    return -1;
+  }
+
+  const int fd = socket(addr.ss_family, SOCK_STREAM | SOCK_NONBLOCK, 0);
+  if (fd < 0) { return Fail("socket"); }
+
+  if (e.path.empty()) {
+    const int on = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+  } else {
+    unlink(e.path.c_str());
+  }
+
+  if (bind(fd, reinterpret_cast<sockaddr*>(&addr), length) < 0) {
+    return Fail("bind", fd);
+  }
+  if (listen(fd, SOMAXCONN) < 0) {
+    return Fail("listen", fd);
+  }
+
+  return fd;
+}
+
+
+int Connect(const Endpoint& e) {
+  sockaddr_storage addr;
+  const auto length = MakeAddress(e, addr);
+  if (length == 0) {
+    std::fprintf(stderr, "Socket path too long: %s\n", e.path.c_str());
+    return -1;
+  }
+
+  const int fd = socket(addr.ss_family, SOCK_STREAM, 0);
+  if (fd < 0) { return Fail("socket"); }
+
+  if (connect(fd, reinterpret_cast<sockaddr*>(&addr), length) < 0) {
+    return Fail("connect", fd);
+  }
+
+  // Requests are small and latency matters more than packet count
+  if (e.path.empty()) {
+    const int on = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+  }
+
+  if (SetNonBlocking(fd) < 0) {
+    return Fail("fcntl", fd);
+  }
+
+  return fd;
+}
+
+
+int SetNonBlocking(int fd) {
+  const int flags = fcntl(fd, F_GETFL, 0);
+  if (flags < 0) { return -1; }
+  return fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
+
+
+void RaiseFileLimit() {
+  rlimit limit;
+  if (getrlimit(RLIMIT_NOFILE, &limit) == 0) {
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+  }
+}
+
+
+} // namespace Tetris
@@ -0,0 +1,219 @@
+#include "observation.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+
+namespace Tetris {
+
+
+namespace {
+
+
+// Write bit i of bits as byte i of out, 0 or 1, for i < 16. All 16 bytes are
+// written even if fewer are needed.
+void UnpackBytes16(uint32_t bits, uint8_t* out) {
+#if defined(__SSE2__)
+  // Byte i of the vector holds the byte of bits that bit i lives in, then
+  // each byte tests its own bit
+  const uint64_t lo = (bits & 0xFF) * 0x0101010101010101ULL;
+  const uint64_t hi = (bits >> 8 & 0xFF) * 0x0101010101010101ULL;
+  const auto select = _mm_set1_epi64x(0x8040201008040201LL);
+  auto v = _mm_set_epi64x(hi, lo);
+  v = _mm_cmpeq_epi8(_mm_and_si128(v, select), select);
+  v = _mm_and_si128(v, _mm_set1_epi8(1));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(out), v);
+#else
+  for (int i = 0; i < 16; ++i) {
+    out[i] = bits >> i & 1;
+  }
+#endif
+}
+
+
+// Write bit i of bits as out[i], 0.0 or 1.0, for i < n
+void UnpackFloats(uint64_t bits, int n, float* out) {
+  int i = 0;
+
+#if defined(__SSE2__)
+  // Four bits at a time: lane j keeps bit j and turns it into the bit
+  // pattern of 1.0f
+  const auto select = _mm_set_epi32(8, 4, 2, 1);
+  const auto one = _mm_castps_si128(_mm_set1_ps(1.0f));
+  for (; i+4 <= n; i += 4) {
+    auto v = _mm_set1_epi32(static_cast<int>(bits >> i & 0xF));
+    v = _mm_cmpeq_epi32(_mm_and_si128(v, select), select);
+    _mm_storeu_ps(out + i, _mm_castsi128_ps(_mm_and_si128(v, one)));
+  }
+#endif
+
+  for (; i < n; ++i) {
+    out[i] = static_cast<float>(bits >> i & 1);
+  }
+}
+
+
+} // namespace
+
+
+template <typename BoardT>
+void EncodeObservation(const BasicGame<BoardT>& game, uint8_t* out) {
+  using Layout = ObservationLayout<BoardT>;
+
+  // Unpack 16 cells at a time. The bytes spilled past the end of a row are
+  // overwritten by the next row, or by the piece and queue after the board.
+  uint8_t* cells = out + Layout::board;
+  for (int row = 0; row < BoardT::rows; ++row) {
+    const auto bits = game.board.matrix[row];
+    for (int col = 0; col < BoardT::cols; col += 16) {
+      const int offset = row*BoardT::cols + col;
+      if (Layout::board + offset + 16 <= Layout::size) {
+        UnpackBytes16(bits >> col, cells + offset);
+        continue;
+      }
+
+      for (int c = col; c < BoardT::cols; ++c) {
+        cells[row*BoardT::cols + c] = bits >> c & 1;
+      }
+      break;
+    }
+  }
+
+  for (const auto& p : game.current_piece.cells()) {
+    cells[p.row*BoardT::cols + p.col] = 2;
+  }
+
+  out[Layout::piece] = static_cast<uint8_t>(game.current_piece.type);
+
+  const auto& queue = game.queue();
+  for (int i = 0; i < Layout::queue_size; ++i) {
+    out[Layout::queue + i] = i < queue.size() ?
+      static_cast<uint8_t>(queue[i]) : no_piece;
+  }
+}
+
+
+template <typename BoardT>
+PlaneEncoder<BoardT>::PlaneEncoder(PlaneLayout layout, int preview)
+    : layout_{layout},
+      planes_{fixed_planes + std::clamp(preview, 0, PieceQueue::capacity)} {
+}
+
+
+template <typename BoardT>
+int PlaneEncoder<BoardT>::planes() const {
+  return planes_;
+}
+
+
+template <typename BoardT>
+size_t PlaneEncoder<BoardT>::size() const {
+  const size_t cells = planes_*Board::rows*Board::cols;
+  switch (layout_) {
+    case PlaneLayout::PACKED_BITS:
+      return planes_*Board::rows*sizeof(Row);
+    case PlaneLayout::UINT8_HWC:
+      return cells;
+    case PlaneLayout::FLOAT_CHW:
+      return cells*sizeof(float);
+  }
+  return 0;
+}
+
+
+template <typename BoardT>
+void PlaneEncoder<BoardT>::Encode(const Game& game, void* out) const {
+  Planes planes{};
+  std::copy_n(game.board.matrix, Board::rows, planes[0].begin());
+
+  auto Draw = [&planes] (int plane, const Points& cells) {
+    for (const auto& p : cells) {
+      planes[plane][p.row] |= Row{1} << p.col;
+    }
+  };
+
+  Draw(1, game.current_piece.cells());
+  Draw(2, game.GetDestination());
+
+  const auto& queue = game.queue();
+  for (int i = 0; i < planes_-fixed_planes && i < queue.size(); ++i) {
+    Draw(fixed_planes+i, Piece::Spawn(queue[i], Board::cols).cells());
+  }
+
+  switch (layout_) {
+    case PlaneLayout::PACKED_BITS:
+      for (int p = 0; p < planes_; ++p) {
+        std::memcpy(static_cast<Row*>(out) + p*Board::rows,
+                    planes[p].data(), sizeof(planes[p]));
+      }
+      break;
+    case PlaneLayout::UINT8_HWC:
+      WriteBytes(planes, static_cast<uint8_t*>(out));
+      break;
+    case PlaneLayout::FLOAT_CHW:
+      WriteFloats(planes, static_cast<float*>(out));
+      break;
+  }
+}
+
+
+template <typename BoardT>
+void PlaneEncoder<BoardT>::WriteBytes(
+    const Planes& planes, uint8_t* out) const {
+  static_assert(max_planes <= 16);
+  const size_t end = size();
+  size_t offset = 0;
+
+  for (int row = 0; row < Board::rows; ++row) {
+    // Gather the planes of each cell into one word, bit p for plane p
+    std::array<uint16_t, Board::cols> cells{};
+    for (int p = 0; p < planes_; ++p) {
+      for (Row bits = planes[p][row]; bits; bits &= bits - 1) {
+        cells[std::countr_zero(bits)] |= 1 << p;
+      }
+    }
+
+    // Cells are written in order, so the bytes a wide write spills past a
+    // cell are overwritten by the next one. Only the end of the buffer
+    // needs care.
+    for (int col = 0; col < Board::cols; ++col) {
+      if (offset + 16 <= end) {
+        UnpackBytes16(cells[col], out + offset);
+      } else {
+        for (int p = 0; p < planes_; ++p) {
+          out[offset+p] = cells[col] >> p & 1;
+        }
+      }
+      offset += planes_;
+    }
+  }
+}
+
+
+template <typename BoardT>
+void PlaneEncoder<BoardT>::WriteFloats(
+    const Planes& planes, float* out) const {
+  for (int p = 0; p < planes_; ++p) {
+    for (int row = 0; row < Board::rows; ++row) {
+      UnpackFloats(planes[p][row], Board::cols, out);
+      out += Board::cols;
+    }
+  }
+}
+
+
+template void EncodeObservation(const BasicGame<Board>&, uint8_t*);
+template void EncodeObservation(const BasicGame<TallBoard>&, uint8_t*);
+template void EncodeObservation(const BasicGame<WideBoard>&, uint8_t*);
+
+template class PlaneEncoder<Board>;
+template class PlaneEncoder<TallBoard>;
+template class PlaneEncoder<WideBoard>;
+
+
+} // namespace Tetris
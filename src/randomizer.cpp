@@ -0,0 +1,113 @@
+#include "randomizer.hpp"
+
+
+namespace Tetris {
+
+
+static uint32_t Rotl(uint32_t x, int k) {
+  return (x << k) | (x >> (32 - k));
+}
+
+
+// Rng
+void Rng::Seed(uint64_t seed) {
+  // Expand the seed with splitmix64, which never yields an all-zero state
+  for (int i = 0; i < 4; i += 2) {
+    uint64_t z = (seed += 0x9E3779B97F4A7C15u);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9u;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBu;
+    z ^= z >> 31;
+    state[i] = static_cast<uint32_t>(z);
+    state[i+1] = static_cast<uint32_t>(z >> 32);
+  }
+}
+
+
+uint32_t Rng::Next() {
+  const uint32_t result = Rotl(state[1] * 5, 7) * 9;
+  const uint32_t t = state[1] << 9;
+
+  state[2] ^= state[0];
+  state[3] ^= state[1];
+  state[1] ^= state[2];
+  state[0] ^= state[3];
+  state[2] ^= t;
+  state[3] = Rotl(state[3], 11);
+
+  return result;
+}
+
+
+uint32_t Rng::Below(uint32_t n) {
+  // Lemire's multiply-shift, rejecting the few values that would bias it
+  uint64_t m = uint64_t{Next()} * n;
+  if (static_cast<uint32_t>(m) < n) {
+    const uint32_t threshold = -n % n;
+    while (static_cast<uint32_t>(m) < threshold) {
+      m = uint64_t{Next()} * n;
+    }
+  }
+  return m >> 32;
+}
+
+
+// Randomizer
+void Randomizer::Seed(uint64_t seed, RandomizerPolicy p) {
+  rng.Seed(seed);
+  policy = p;
+  bag_size = 0;
+  for (auto& h : history) {
+    h = static_cast<uint8_t>(PieceType::Z);
+  }
+  first = true;
+}
+
+
+PieceType Randomizer::Next() {
+  switch (policy) {
+    case RandomizerPolicy::BAG: {
+      if (bag_size == 0) {
+        for (uint8_t i = 0; i < 7; ++i) {
+          bag[i] = i;
+        }
+        bag_size = 7;
+      }
+
+      // Draw a random remaining piece and swap it out of the bag
+      const auto i = rng.Below(bag_size);
+      const auto piece = bag[i];
+      bag[i] = bag[--bag_size];
+      return static_cast<PieceType>(piece);
+    }
+
+    case RandomizerPolicy::HISTORY: {
+      uint8_t piece = 0;
+      if (first) {
+        constexpr PieceType openers[] = {
+          PieceType::I, PieceType::J, PieceType::L, PieceType::T};
+        piece = static_cast<uint8_t>(openers[rng.Below(4)]);
+        first = false;
+      } else {
+        for (int roll = 0; roll < 4; ++roll) {
+          piece = rng.Below(7);
+          if (piece != history[0] && piece != history[1] &&
+              piece != history[2] && piece != history[3]) {
+            break;
+          }
+        }
+      }
+
+      history[3] = history[2];
+      history[2] = history[1];
+      history[1] = history[0];
+      history[0] = piece;
+      return static_cast<PieceType>(piece);
+    }
+
+    default:
+      return static_cast<PieceType>(rng.Below(7));
+  }
+}
+
+
+} // namespace Tetris
@@ -78,7 +78,6 @@ void Renderer::Render() {
 
   state_->Render();
   SDL_RenderPresent(renderer_);
-  SDL_Delay(1000/60);
 }
 
 
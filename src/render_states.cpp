@@ -81,7 +81,7 @@ void RenderStatePlaying::DrawGrid() {
 void RenderStatePlaying::DrawCurrentPiece() {
   auto r = info.renderer;
   const auto& g = info.game;
-  const auto cur_type = g.current_piece->type;
+  const auto cur_type = g.current_piece.type;
 
   SDL_SetRenderDrawColor(
       r,
@@ -90,7 +90,7 @@ void RenderStatePlaying::DrawCurrentPiece() {
       piece_colors_[cur_type].b,
       piece_colors_[cur_type].a);
 
-  for (const auto& p : *g.current_piece) {
+  for (const auto& p : g.current_piece.cells()) {
     const auto row = p.row;
     const auto col = p.col;
     SDL_Rect rect{col*dx()+1, row*dy()+1, dx()-2, dy()-2};
@@ -102,7 +102,7 @@ void RenderStatePlaying::DrawCurrentPiece() {
 void RenderStatePlaying::DrawDestination() {
   auto r = info.renderer;
   const auto& g = info.game;
-  const auto cur_type = g.current_piece->type;
+  const auto cur_type = g.current_piece.type;
   SDL_SetRenderDrawColor(
       r, 
       piece_colors_[cur_type].r,
@@ -122,7 +122,9 @@ void RenderStatePlaying::DrawNextPiece() {
   auto r = info.renderer;
   const auto& g = info.game;
 
-  const auto next_type = g.next_piece->type;
+  // Lay out the preview as on a standard board, independent of the grid
+  const auto next_piece = Piece::Spawn(g.queue()[0], 10);
+  const auto next_type = next_piece.type;
   SDL_SetRenderDrawColor(
       r, 
       piece_colors_[next_type].r,
@@ -130,7 +132,7 @@ void RenderStatePlaying::DrawNextPiece() {
       piece_colors_[next_type].b,
       piece_colors_[next_type].a);
 
-  for (const auto& p : *g.next_piece) {
+  for (const auto& p : next_piece.cells()) {
     const auto row = p.row;
     const auto col = p.col;
     SDL_Rect rect{
@@ -154,7 +156,7 @@ void RenderStatePlaying::DrawBoard() {
   SDL_SetRenderDrawColor(r, c.r, c.g, c.b, c.a);
   for (int row = 0; row < g.board.rows; ++row) {
     for (int col = 0; col < g.board.cols; ++col) {
-      if (g.board.matrix[row][col] == 0) { continue; }
+      if (!g.board.Filled(row, col)) { continue; }
 
       SDL_Rect rect{col*dx()+1, row*dy()+1, dx()-2, dy()-2};
       SDL_RenderFillRect(r, &rect);
@@ -225,7 +227,7 @@ RenderStateRowClear::RenderStateRowClear(
     RenderInfo info)
     : RenderStatePlaying{info}
     , ticks_{SDL_GetTicks64()} {
-  rows_cleared_ = info.game.GetFullRows();
+  rows_cleared_ = info.game.FullRows();
 }
 
 
@@ -240,7 +242,9 @@ void RenderStateRowClear::Render() {
     SDL_SetRenderDrawColor(r, bg.r, bg.g, bg.b, bg.a) :
     SDL_SetRenderDrawColor(r, fill.r, fill.g, fill.b, fill.a);
 
-  for (const auto& row : rows_cleared_) {
+  for (int row = 0; row < g.board.rows; ++row) {
+    if ((rows_cleared_ >> row & 1) == 0) { continue; }
+
     for (int col = 0; col < g.board.cols; ++col) {
       SDL_Rect rect{col*dx()+1, row*dy()+1, dx()-2, dy()-2};
       SDL_RenderFillRect(r, &rect);
@@ -289,7 +293,8 @@ void RenderStateGameOver::Render() {
 
   // Render text
   const std::string str = "Game Over!\n\nPress R to restart.";
-  FC_DrawAlign(info.font, r, 5*dx(), 10*dy(), FC_ALIGN_CENTER, str.c_str());
+  FC_DrawAlign(
+      info.font, r, grid_width()/2, 10*dy(), FC_ALIGN_CENTER, str.c_str());
 }
 
 
@@ -319,7 +324,7 @@ void RenderStatePaused::Render() {
   FC_DrawAlign(
       info.font,
       info.renderer,
-      5*dx(),
+      grid_width()/2,
       10*dy(),
       FC_ALIGN_CENTER,
       "Paused");
@@ -0,0 +1,318 @@
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "game.hpp"
+#include "net.hpp"
+#include "protocol.hpp"
+
+
+// Match server: hosts many independent games for bots connecting over a
+// Unix domain socket or loopback TCP, speaking the protocol in protocol.hpp.
+// Every worker thread runs its own epoll loop and accepts connections
+// itself, so a session stays on one thread and nothing is shared or locked.
+//
+// Usage: tetris_server [--unix PATH | --port N] [--threads T]
+
+
+namespace {
+
+
+using Tetris::Board;
+using Tetris::Request;
+using Tetris::RequestKind;
+using Tetris::Response;
+using Tetris::RowUpdate;
+
+
+struct Options {
+  Tetris::Endpoint endpoint;
+  unsigned threads = std::thread::hardware_concurrency();
+};
+
+
+Tetris::GameConfig MakeConfig(uint64_t seed) {
+  auto config = Tetris::GameConfig::WithTickRate(60);
+  config.seed = seed;
+  return config;
+}
+
+
+struct Session {
+  explicit Session(int fd) : fd{fd}, game{MakeConfig(0)} {}
+
+  int fd;
+  Tetris::Game game;
+  std::array<Board::Row, Board::rows> sent{}; // Board as the client knows it
+
+  std::array<uint8_t, 64*sizeof(Request)> in;
+  size_t in_size = 0;
+  std::vector<uint8_t> out;
+  size_t out_pos = 0;
+  bool writing = false; // Waiting for the socket to take more output
+};
+
+
+// Sessions of one worker, indexed by file descriptor
+using Sessions = std::vector<std::unique_ptr<Session>>;
+
+
+bool ParseOptions(int argc, char** argv, Options& o) {
+  for (int i = 1; i < argc; ++i) {
+    const bool has_value = i+1 < argc;
+    if (!has_value) { return false; }
+
+    const char* value = argv[++i];
+    if (std::strcmp(argv[i-1], "--unix") == 0) {
+      o.endpoint.path = value;
+    } else if (std::strcmp(argv[i-1], "--port") == 0) {
+      o.endpoint.port = std::strtoul(value, nullptr, 10);
+    } else if (std::strcmp(argv[i-1], "--threads") == 0) {
+      o.threads = std::strtoul(value, nullptr, 10);
+    } else {
+      return false;
+    }
+  }
+
+  o.threads = std::max(1u, o.threads);
+  return true;
+}
+
+
+void Append(std::vector<uint8_t>& out, const void* data, size_t size) {
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  out.insert(out.end(), bytes, bytes + size);
+}
+
+
+// Run one request and queue its response. Returns false on a malformed
+// request.
+bool Handle(Session& s, const Request& request) {
+  auto& game = s.game;
+
+  if (request.kind == RequestKind::RESET) {
+    game = Tetris::Game{MakeConfig(request.seed)};
+    s.sent.fill(0);
+  } else if (request.kind != RequestKind::STEP ||
+             request.action > Tetris::Action::HARD_DROP) {
+    return false;
+  }
+
+  const auto score = game.score();
+  const auto lines = game.lines();
+
+  if (request.kind == RequestKind::STEP && !game.game_over()) {
+    if (request.action != Tetris::Action::NOOP) {
+      const auto input = static_cast<int>(request.action) - 1;
+      game.Apply(static_cast<Tetris::Input>(input));
+    }
+    for (int i = 0; i < request.ticks && !game.game_over(); ++i) {
+      game.Tick();
+    }
+  }
+
+  uint8_t num_rows = 0;
+  for (int row = 0; row < Board::rows; ++row) {
+    num_rows += game.board.matrix[row] != s.sent[row];
+  }
+
+  const auto& piece = game.current_piece;
+  Response response;
+  response.sequence = request.sequence;
+  response.reward = static_cast<uint32_t>(game.score() - score);
+  // state() only reaches GAMEOVER a few ticks after the top-out
+  response.state = game.game_over() ?
+    Tetris::GameState::GAMEOVER : game.state();
+  response.piece = piece.type;
+  response.rotation = piece.rotation;
+  response.row = static_cast<int8_t>(piece.origin.row);
+  response.col = static_cast<int8_t>(piece.origin.col);
+  response.next = game.queue()[0];
+  response.lines = static_cast<uint8_t>(game.lines() - lines);
+  response.num_rows = num_rows;
+  Append(s.out, &response, sizeof(response));
+
+  for (int row = 0; row < Board::rows; ++row) {
+    if (game.board.matrix[row] == s.sent[row]) { continue; }
+
+    RowUpdate update;
+    update.row = static_cast<uint8_t>(row);
+    update.cells = game.board.matrix[row];
+    Append(s.out, &update, sizeof(update));
+    s.sent[row] = game.board.matrix[row];
+  }
+
+  return true;
+}
+
+
+// Write as much pending output as the socket takes. While output is left,
+// stop reading so a client that does not read cannot grow the buffer.
+bool Flush(int epoll, Session& s) {
+  while (s.out_pos < s.out.size()) {
+    const auto n = send(s.fd, s.out.data() + s.out_pos,
+                        s.out.size() - s.out_pos, MSG_NOSIGNAL);
+    if (n < 0) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK) { break; }
+      return false;
+    }
+    s.out_pos += n;
+  }
+
+  const bool pending = s.out_pos < s.out.size();
+  if (!pending) {
+    s.out.clear();
+    s.out_pos = 0;
+  }
+
+  if (pending != s.writing) {
+    s.writing = pending;
+    epoll_event ev{};
+    ev.events = pending ? EPOLLOUT : EPOLLIN;
+    ev.data.fd = s.fd;
+    epoll_ctl(epoll, EPOLL_CTL_MOD, s.fd, &ev);
+  }
+
+  return true;
+}
+
+
+// Handle readiness of a session. Returns false if it should be closed.
+bool Service(int epoll, Session& s, uint32_t events) {
+  if (events & (EPOLLERR | EPOLLHUP)) { return false; }
+
+  if (events & EPOLLIN) {
+    const auto n = read(s.fd, s.in.data() + s.in_size,
+                        s.in.size() - s.in_size);
+    if (n == 0) { return false; }
+    if (n < 0) { return errno == EAGAIN || errno == EWOULDBLOCK; }
+    s.in_size += n;
+
+    size_t pos = 0;
+    for (; pos + sizeof(Request) <= s.in_size; pos += sizeof(Request)) {
+      Request request;
+      std::memcpy(&request, s.in.data() + pos, sizeof(request));
+      if (!Handle(s, request)) { return false; }
+    }
+
+    std::memmove(s.in.data(), s.in.data() + pos, s.in_size - pos);
+    s.in_size -= pos;
+  }
+
+  return Flush(epoll, s);
+}
+
+
+void Accept(int epoll, int listener, bool tcp, Sessions& sessions) {
+  while (true) {
+    // Fails with EAGAIN once the backlog is empty, or if another worker
+    // took the connection first
+    const int fd = accept4(listener, nullptr, nullptr, SOCK_NONBLOCK);
+    if (fd < 0) { return; }
+
+    if (tcp) {
+      const int on = 1;
+      setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    }
+
+    if (static_cast<size_t>(fd) >= sessions.size()) {
+      sessions.resize(fd + 1);
+    }
+    sessions[fd] = std::make_unique<Session>(fd);
+
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = fd;
+    epoll_ctl(epoll, EPOLL_CTL_ADD, fd, &ev);
+  }
+}
+
+
+void Worker(int listener, bool tcp) {
+  const int epoll = epoll_create1(0);
+  if (epoll < 0) {
+    std::perror("epoll_create1");
+    return;
+  }
+
+  // Every worker waits on the listener, and EPOLLEXCLUSIVE wakes only one
+  // of them per connection
+  epoll_event ev{};
+  ev.events = EPOLLIN | EPOLLEXCLUSIVE;
+  ev.data.fd = listener;
+  epoll_ctl(epoll, EPOLL_CTL_ADD, listener, &ev);
+
+  Sessions sessions;
+  std::array<epoll_event, 256> events;
+  while (true) {
+    const int n = epoll_wait(epoll, events.data(), events.size(), -1);
+    if (n < 0 && errno != EINTR) {
+      std::perror("epoll_wait");
+      break;
+    }
+
+    for (int i = 0; i < n; ++i) {
+      const int fd = events[i].data.fd;
+      if (fd == listener) {
+        Accept(epoll, listener, tcp, sessions);
+        continue;
+      }
+
+      if (!Service(epoll, *sessions[fd], events[i].events)) {
+        close(fd);
+        sessions[fd].reset();
+      }
+    }
+  }
+
+  close(epoll);
+}
+
+
+} // namespace
+
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!ParseOptions(argc, argv, options)) {
+    std::fprintf(stderr,
+        "Usage: %s [--unix PATH | --port N] [--threads T]\n", argv[0]);
+    return 1;
+  }
+
+  Tetris::RaiseFileLimit();
+  const int listener = Tetris::Listen(options.endpoint);
+  if (listener < 0) { return 1; }
+
+  const bool tcp = options.endpoint.path.empty();
+  if (tcp) {
+    std::printf("listening on 127.0.0.1:%u, %u threads\n",
+        options.endpoint.port, options.threads);
+  } else {
+    std::printf("listening on %s, %u threads\n",
+        options.endpoint.path.c_str(), options.threads);
+  }
+  std::fflush(stdout);
+
+  std::vector<std::thread> threads;
+  for (unsigned t = 0; t < options.threads; ++t) {
+    threads.emplace_back(Worker, listener, tcp);
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  return 0;
+}
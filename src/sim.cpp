@@ -0,0 +1,224 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "agent.hpp"
+#include "game.hpp"
+#include "versus.hpp"
+
+
+// Headless throughput harness: plays independent games on a pool of threads
+// and reports how fast the engine runs. With --versus, every game is instead
+// a match between --agent and the named opponent, exchanging garbage.
+//
+// Usage: tetris_sim [--games N] [--threads T] [--agent NAME] [--seed S]
+//                   [--max-pieces P] [--randomizer uniform|bag|history]
+//                   [--versus NAME]
+
+
+namespace {
+
+
+struct Options {
+  uint64_t games = 1000;
+  unsigned threads = std::thread::hardware_concurrency();
+  std::string agent = "random";
+  uint64_t seed = 1;
+  uint64_t max_pieces = 10000;
+  Tetris::RandomizerPolicy randomizer = Tetris::RandomizerPolicy::UNIFORM;
+  std::string versus; // Opponent agent, empty for single player games
+};
+
+
+struct Totals {
+  uint64_t games = 0;
+  uint64_t pieces = 0;
+  uint64_t lines = 0;
+  uint64_t ticks = 0;
+  uint64_t wins[2] = {0, 0}; // Versus matches won by each player
+  uint64_t garbage = 0; // Garbage rows sent in versus matches
+};
+
+
+bool ParseOptions(int argc, char** argv, Options& o) {
+  for (int i = 1; i < argc; ++i) {
+    const bool has_value = i+1 < argc;
+    if (!has_value) { return false; }
+
+    const char* value = argv[++i];
+    if (std::strcmp(argv[i-1], "--games") == 0) {
+      o.games = std::strtoull(value, nullptr, 10);
+    } else if (std::strcmp(argv[i-1], "--threads") == 0) {
+      o.threads = std::strtoul(value, nullptr, 10);
+    } else if (std::strcmp(argv[i-1], "--agent") == 0) {
+      o.agent = value;
+    } else if (std::strcmp(argv[i-1], "--seed") == 0) {
+      o.seed = std::strtoull(value, nullptr, 10);
+    } else if (std::strcmp(argv[i-1], "--max-pieces") == 0) {
+      o.max_pieces = std::strtoull(value, nullptr, 10);
+    } else if (std::strcmp(argv[i-1], "--versus") == 0) {
+      o.versus = value;
+    } else if (std::strcmp(argv[i-1], "--randomizer") == 0) {
+      if (std::strcmp(value, "uniform") == 0) {
+        o.randomizer = Tetris::RandomizerPolicy::UNIFORM;
+      } else if (std::strcmp(value, "bag") == 0) {
+        o.randomizer = Tetris::RandomizerPolicy::BAG;
+      } else if (std::strcmp(value, "history") == 0) {
+        o.randomizer = Tetris::RandomizerPolicy::HISTORY;
+      } else {
+        return false;
+      }
+    } else {
+      return false;
+    }
+  }
+
+  o.threads = std::max(1u, o.threads);
+  return true;
+}
+
+
+// Play versus matches until the shared counter runs out. Both players get
+// the same pieces; a match that reaches the piece limit is a draw.
+void VersusWorker(
+    const Options& o, std::atomic<uint64_t>& next, Totals& totals) {
+  Tetris::VersusConfig config;
+  config.game = Tetris::GameConfig::WithTickRate(60);
+  config.game.randomizer = o.randomizer;
+
+  for (auto i = next++; i < o.games; i = next++) {
+    config.game.seed = o.seed + i;
+    Tetris::Versus match{config};
+    std::unique_ptr<Tetris::Agent> agents[2] = {
+      Tetris::MakeAgent(o.agent, config.game.seed),
+      Tetris::MakeAgent(o.versus, config.game.seed + 1)};
+
+    while (!match.over() &&
+           std::max(match.games[0].pieces(), match.games[1].pieces()) <
+           o.max_pieces) {
+      agents[0]->Act(match.games[0]);
+      agents[1]->Act(match.games[1]);
+      match.Tick();
+    }
+
+    totals.games += 1;
+    if (match.winner() >= 0) {
+      totals.wins[match.winner()] += 1;
+    }
+
+    for (int p = 0; p < 2; ++p) {
+      totals.pieces += match.games[p].pieces();
+      totals.lines += match.games[p].lines();
+      totals.ticks += match.games[p].tick();
+      totals.garbage += match.sent(p);
+    }
+  }
+}
+
+
+// Play games until the shared counter runs out, accumulating into totals.
+void Worker(const Options& o, std::atomic<uint64_t>& next, Totals& totals) {
+  if (!o.versus.empty()) {
+    VersusWorker(o, next, totals);
+    return;
+  }
+
+  auto config = Tetris::Game::Config::WithTickRate(60);
+  config.randomizer = o.randomizer;
+
+  for (auto i = next++; i < o.games; i = next++) {
+    config.seed = o.seed + i;
+    Tetris::Game game{config};
+    auto agent = Tetris::MakeAgent(o.agent, config.seed);
+
+    while (!game.game_over() && game.pieces() < o.max_pieces) {
+      agent->Act(game);
+      game.Tick();
+    }
+
+    totals.games += 1;
+    totals.pieces += game.pieces();
+    totals.lines += game.lines();
+    totals.ticks += game.tick();
+  }
+}
+
+
+} // namespace
+
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!ParseOptions(argc, argv, options)) {
+    std::fprintf(stderr,
+        "Usage: %s [--games N] [--threads T] [--agent NAME] [--seed S] "
+        "[--max-pieces P] [--randomizer uniform|bag|history] "
+        "[--versus NAME]\n", argv[0]);
+    return 1;
+  }
+
+  for (const auto& name : {options.agent, options.versus}) {
+    if (!name.empty() && !Tetris::MakeAgent(name, 0)) {
+      std::fprintf(stderr, "Unknown agent: %s\n", name.c_str());
+      return 1;
+    }
+  }
+
+  std::atomic<uint64_t> next{0};
+  std::vector<Totals> totals(options.threads);
+  std::vector<std::thread> threads;
+
+  const auto start = std::chrono::steady_clock::now();
+  for (unsigned t = 0; t < options.threads; ++t) {
+    threads.emplace_back(
+        Worker, std::cref(options), std::ref(next), std::ref(totals[t]));
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  const std::chrono::duration<double> elapsed =
+    std::chrono::steady_clock::now() - start;
+
+  Totals sum;
+  for (const auto& t : totals) {
+    sum.games += t.games;
+    sum.pieces += t.pieces;
+    sum.lines += t.lines;
+    sum.ticks += t.ticks;
+    sum.wins[0] += t.wins[0];
+    sum.wins[1] += t.wins[1];
+    sum.garbage += t.garbage;
+  }
+
+  const double s = elapsed.count();
+  std::printf("agent %s, %u threads, %.3f s\n",
+      options.agent.c_str(), options.threads, s);
+  std::printf("games   %12llu  %14.1f /s\n",
+      static_cast<unsigned long long>(sum.games), sum.games/s);
+  std::printf("pieces  %12llu  %14.1f /s\n",
+      static_cast<unsigned long long>(sum.pieces), sum.pieces/s);
+  std::printf("lines   %12llu  %14.1f /s\n",
+      static_cast<unsigned long long>(sum.lines), sum.lines/s);
+  std::printf("ticks   %12llu  %14.1f /s\n",
+      static_cast<unsigned long long>(sum.ticks), sum.ticks/s);
+
+  if (!options.versus.empty()) {
+    const auto draws = sum.games - sum.wins[0] - sum.wins[1];
+    std::printf("%s %llu, %s %llu, draws %llu, garbage rows %llu\n",
+        options.agent.c_str(),
+        static_cast<unsigned long long>(sum.wins[0]),
+        options.versus.c_str(),
+        static_cast<unsigned long long>(sum.wins[1]),
+        static_cast<unsigned long long>(draws),
+        static_cast<unsigned long long>(sum.garbage));
+  }
+
+  return 0;
+}
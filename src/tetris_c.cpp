@@ -0,0 +1,172 @@
+#include "tetris.h"
+
+#include <new>
+
+#include "game.hpp"
+#include "game_batch.hpp"
+#include "observation.hpp"
+
+
+using Layout = Tetris::ObservationLayout<Tetris::Board>;
+
+static_assert(TETRIS_ROWS == Tetris::Board::rows);
+static_assert(TETRIS_COLS == Tetris::Board::cols);
+static_assert(TETRIS_QUEUE_SIZE == Layout::queue_size);
+static_assert(TETRIS_OBS_PIECE == Layout::piece);
+static_assert(TETRIS_OBS_QUEUE == Layout::queue);
+static_assert(TETRIS_OBS_SIZE == Layout::size);
+static_assert(TETRIS_NO_PIECE == Tetris::no_piece);
+static_assert(std::is_same_v<Tetris::Board::Row, uint16_t>);
+static_assert(TETRIS_HARD_DROP == static_cast<int>(Tetris::Action::HARD_DROP));
+static_assert(sizeof(Tetris::Action) == sizeof(uint8_t));
+static_assert(TETRIS_PLANES_FLOAT_CHW ==
+              static_cast<int>(Tetris::PlaneLayout::FLOAT_CHW));
+
+
+struct tetris_game {
+  Tetris::Game game;
+};
+
+
+struct tetris_batch {
+  Tetris::GameBatch batch;
+};
+
+
+namespace {
+
+
+Tetris::GameConfig MakeConfig(uint64_t seed) {
+  auto config = Tetris::GameConfig::WithTickRate(60);
+  config.seed = seed;
+  return config;
+}
+
+
+} // namespace
+
+
+int tetris_api_version(void) {
+  return TETRIS_API_VERSION;
+}
+
+
+tetris_game* tetris_create(uint64_t seed) {
+  return new (std::nothrow) tetris_game{Tetris::Game{MakeConfig(seed)}};
+}
+
+
+void tetris_destroy(tetris_game* t) {
+  delete t;
+}
+
+
+void tetris_reset(tetris_game* t, uint64_t seed) {
+  t->game = Tetris::Game{MakeConfig(seed)};
+}
+
+
+tetris_step_result tetris_step(tetris_game* t, int action) {
+  using Input = Tetris::Input;
+  auto& game = t->game;
+
+  const auto score = game.score();
+  const auto lines = game.lines();
+
+  switch (action) {
+    case TETRIS_LEFT:
+      game.Apply(Input::LEFT);
+      break;
+    case TETRIS_RIGHT:
+      game.Apply(Input::RIGHT);
+      break;
+    case TETRIS_ROTATE_CW:
+      game.Apply(Input::ROTATE_CW);
+      break;
+    case TETRIS_ROTATE_CCW:
+      game.Apply(Input::ROTATE_CCW);
+      break;
+    case TETRIS_SOFT_DROP:
+      game.Apply(Input::SOFT_DROP);
+      break;
+    case TETRIS_HARD_DROP:
+      game.Apply(Input::HARD_DROP);
+      break;
+  }
+
+  game.Tick();
+
+  tetris_step_result result;
+  result.reward = static_cast<int64_t>(game.score() - score);
+  result.lines = static_cast<int32_t>(game.lines() - lines);
+  result.done = game.game_over();
+  return result;
+}
+
+
+void tetris_observe(const tetris_game* t, uint8_t* obs) {
+  Tetris::EncodeObservation(t->game, obs);
+}
+
+
+uint64_t tetris_score(const tetris_game* t) { return t->game.score(); }
+uint64_t tetris_lines(const tetris_game* t) { return t->game.lines(); }
+uint64_t tetris_pieces(const tetris_game* t) { return t->game.pieces(); }
+
+
+size_t tetris_planes_size(int layout, int preview) {
+  const auto plane_layout = static_cast<Tetris::PlaneLayout>(layout);
+  return Tetris::PlaneEncoder<Tetris::Board>{plane_layout, preview}.size();
+}
+
+
+void tetris_observe_planes(
+    const tetris_game* t, int layout, int preview, void* out) {
+  const auto plane_layout = static_cast<Tetris::PlaneLayout>(layout);
+  Tetris::PlaneEncoder<Tetris::Board>{plane_layout, preview}.Encode(
+      t->game, out);
+}
+
+
+tetris_batch* tetris_batch_create(int size, uint64_t seed) {
+  if (size <= 0) { return nullptr; }
+
+  // No exception may cross into the C caller
+  try {
+    return new tetris_batch{Tetris::GameBatch{size, MakeConfig(seed)}};
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+
+void tetris_batch_destroy(tetris_batch* t) {
+  delete t;
+}
+
+
+void tetris_batch_reset(tetris_batch* t) {
+  t->batch.Reset();
+}
+
+
+void tetris_batch_step(tetris_batch* t, const uint8_t* actions) {
+  const auto n = static_cast<size_t>(t->batch.size());
+  t->batch.Step({reinterpret_cast<const Tetris::Action*>(actions), n});
+}
+
+
+tetris_batch_obs tetris_batch_observations(const tetris_batch* t) {
+  const auto& obs = t->batch.observations();
+
+  tetris_batch_obs result;
+  result.board = obs.board.data();
+  result.piece = obs.piece.data();
+  result.rotation = obs.rotation.data();
+  result.row = obs.row.data();
+  result.col = obs.col.data();
+  result.queue = obs.queue.data();
+  result.reward = obs.reward.data();
+  result.done = obs.done.data();
+  return result;
+}
@@ -0,0 +1,105 @@
+#include "versus.hpp"
+
+#include <algorithm>
+
+
+namespace Tetris {
+
+
+template <typename BoardT>
+BasicVersus<BoardT>::BasicVersus(const VersusConfig& config)
+    : games{Game{config.game}, Game{config.game}}, config_{config} {
+  ResetMatch();
+}
+
+
+template <typename BoardT>
+void BasicVersus<BoardT>::Tick() {
+  if (over()) { return; }
+
+  for (auto& game : games) {
+    game.Tick();
+  }
+
+  // Clearing rows first defends against garbage already on its way
+  int attack[2];
+  for (int i = 0; i < 2; ++i) {
+    const auto cleared = static_cast<int>(games[i].lines() - lines_[i]);
+    lines_[i] = games[i].lines();
+
+    const int size = static_cast<int>(config_.attack.size());
+    attack[i] = games[i].CancelGarbage(
+        config_.attack[std::min(cleared, size-1)]);
+  }
+
+  // Attacks in the same tick cancel out, so neither player moves first
+  const int common = std::min(attack[0], attack[1]);
+  for (int i = 0; i < 2; ++i) {
+    Send(i, attack[i] - common);
+  }
+}
+
+
+// Start the match over from the seed
+template <typename BoardT>
+void BasicVersus<BoardT>::Restart() {
+  games = {Game{config_.game}, Game{config_.game}};
+  ResetMatch();
+}
+
+
+// Reset everything but the games
+template <typename BoardT>
+void BasicVersus<BoardT>::ResetMatch() {
+  rng_.Seed(config_.game.seed ^ 0x9E3779B97F4A7C15ULL);
+  lines_ = {0, 0};
+  sent_ = {0, 0};
+}
+
+
+template <typename BoardT>
+bool BasicVersus<BoardT>::over() const {
+  return games[0].game_over() || games[1].game_over();
+}
+
+
+template <typename BoardT>
+int BasicVersus<BoardT>::winner() const {
+  const bool lost[2] = {games[0].game_over(), games[1].game_over()};
+
+  if (lost[0] == lost[1]) { return -1; }
+  return lost[0] ? 1 : 0;
+}
+
+
+template <typename BoardT>
+uint64_t BasicVersus<BoardT>::sent(int player) const {
+  return sent_[player];
+}
+
+
+template <typename BoardT>
+void BasicVersus<BoardT>::Send(int from, int rows) {
+  if (rows == 0) { return; }
+
+  sent_[from] += rows;
+  auto& target = games[1-from];
+  switch (config_.holes) {
+    case GarbageHoles::CLEAN:
+      target.QueueGarbage(rows, rng_.Below(Board::cols));
+      break;
+    case GarbageHoles::MESSY:
+      for (int i = 0; i < rows; ++i) {
+        target.QueueGarbage(1, rng_.Below(Board::cols));
+      }
+      break;
+  }
+}
+
+
+template class BasicVersus<Board>;
+template class BasicVersus<TallBoard>;
+template class BasicVersus<WideBoard>;
+
+
+} // namespace Tetris